@@ -35,6 +35,103 @@ public enum ElementType: Int {
     case polygons
     case connectedPolygons
     case boundaryContours
+    /// Triangle strips, each followed by a -1 separator.
+    case triangleStrips
+    /// Triangle fans, each followed by a -1 separator.
+    case triangleFans
+    /// Triangles grouped into meshlets, see `TessC.meshlets`.
+    case meshlets
+    /// Unique edges of the polygons, as pairs of indices, see
+    /// `TessC.boundaryEdges`.
+    case edges
+    /// Trapezoids cut from the sweep, 4 indices each: lower left, lower
+    /// right, upper right, upper left. The left and right sides are
+    /// parallel to the sweep line, which for input in the xy plane is
+    /// vertical.
+    case trapezoids
+}
+
+/// A cluster of adjacent triangles in `.meshlets` output.
+public struct Meshlet {
+    /// Indices of the meshlet's vertices in the tesselated vertices.
+    public var vertices: [Int]
+    /// Local index buffer, 3 indices into `vertices` per triangle.
+    public var triangles: [UInt8]
+    /// Bounding box of the meshlet's vertices.
+    public var boundsMin: CVector3
+    public var boundsMax: CVector3
+}
+
+/// Tesselation output detached from its `TessC` by `tessellateDetached`.
+/// Owns the buffers, which are freed on deinit, so it can be handed to
+/// another thread while the `TessC` tesselates the next input.
+public final class TessResult {
+    let result: UnsafeMutablePointer<TESSresult>
+    
+    /// Number of coordinates per vertex in `vertices`.
+    public let vertexSize: Int
+    /// Number of indices per element in `elements` for `.polygons` output.
+    public let polySize: Int
+    public let elementType: ElementType
+    
+    init(result: UnsafeMutablePointer<TESSresult>, elementType: ElementType, polySize: Int, vertexSize: Int) {
+        self.result = result
+        self.elementType = elementType
+        self.polySize = polySize
+        self.vertexSize = vertexSize
+    }
+    
+    deinit {
+        tessFreeResult(result)
+    }
+    
+    public var vertexCount: Int {
+        return Int(result.pointee.vertexCount)
+    }
+    
+    public var elementCount: Int {
+        return Int(result.pointee.elementCount)
+    }
+    
+    /// Vertex coordinates, `vertexSize` per vertex.
+    public var vertices: UnsafeBufferPointer<TESSreal> {
+        return UnsafeBufferPointer(start: result.pointee.vertices, count: vertexCount * vertexSize)
+    }
+    
+    /// Original index of each vertex, as in `TessC.vertexIndices`.
+    public var vertexIndices: UnsafeBufferPointer<TESSindex> {
+        return UnsafeBufferPointer(start: result.pointee.vertexIndices, count: vertexCount)
+    }
+    
+    /// Element array, laid out as by libtess2's `tessGetElements()`, with
+    /// unused polygon slots and separators set to `~0`.
+    public var elements: UnsafeBufferPointer<TESSindex> {
+        return UnsafeBufferPointer(start: result.pointee.elements, count: Int(result.pointee.indexCount))
+    }
+    
+    /// The part of the output added by each tesselation, as `TessC.drawRanges`.
+    public var drawRanges: UnsafeBufferPointer<TESSdrawRange> {
+        return UnsafeBufferPointer(start: result.pointee.drawRanges, count: Int(result.pointee.drawRangeCount))
+    }
+}
+
+/// Bounding box, centroid and area of an output element, see
+/// `TessC.computeElementMetrics`.
+public struct ElementMetrics {
+    public var boundsMin: CVector3
+    public var boundsMax: CVector3
+    /// Area centroid, or the average of the vertices for empty elements.
+    public var centroid: CVector3
+    public var area: TESSreal
+}
+
+/// Data structure used for the sweep line edge dictionary.
+public enum EdgeDictionary: Int {
+    /// Sorted linked list; O(n) lookups in the number of edges crossing the
+    /// sweep line.
+    case list
+    /// Skip list with finger search; O(log n) lookups. The default.
+    case skipList
 }
 
 public enum ContourOrientation {
@@ -86,6 +183,184 @@ open class TessC {
         }
     }
     
+    /// Data structure used to order the edges crossing the sweep line.
+    /// `.skipList` keeps inputs with thousands of simultaneously active edges
+    /// from going quadratic.
+    /// Defaults to `.skipList`.
+    public var edgeDictionary: EdgeDictionary {
+        get {
+            return EdgeDictionary(rawValue: Int(tessGetDictType(_tess))) ?? .skipList
+        }
+        set {
+            tessSetDictType(_tess, Int32(newValue.rawValue))
+        }
+    }
+    
+    /// Whether to reorder `.polygons` and `.connectedPolygons` output for the
+    /// GPU's post-transform vertex cache, numbering vertices in the order
+    /// they are first used.
+    /// Defaults to false.
+    public var optimizeVertexCache: Bool {
+        get {
+            return tessGetOptimizeVertexCache(_tess)
+        }
+        set {
+            tessSetOptimizeVertexCache(_tess, newValue)
+        }
+    }
+    
+    /// Whether the triangulation is refined by edge flips until it is
+    /// constrained Delaunay: of the triangulations keeping the edges of the
+    /// contours, the one maximizing the smallest angle, avoiding slivers.
+    /// Applies to all output built from triangles, except `triangleCallback`.
+    /// Defaults to false.
+    public var delaunay: Bool {
+        get {
+            return tessGetDelaunay(_tess)
+        }
+        set {
+            tessSetDelaunay(_tess, newValue)
+        }
+    }
+    
+    /// Declares that the edges of the contours do not cross, overlap or touch
+    /// each other, except at shared vertices. The sweep then skips its
+    /// intersection handling. In debug builds of the C library contours found
+    /// not to be simple make tesselation fail with `simpleViolation` set; in
+    /// release builds the output for them is undefined.
+    /// Defaults to false.
+    public var simpleContours: Bool {
+        get {
+            return tessGetSimpleContours(_tess)
+        }
+        set {
+            tessSetSimpleContours(_tess, newValue)
+        }
+    }
+    
+    /// Whether the last tesselation failed because contours declared simple
+    /// with `simpleContours` were not.
+    public var simpleViolation: Bool {
+        return tessGetSimpleViolation(_tess)
+    }
+    
+    /// Whether tesselations report which contour each element and edge of
+    /// the output comes from, in `elementContours` and `edgeContours`.
+    /// Contours are numbered in the order they are added, from 0 for each
+    /// tesselation.
+    /// Defaults to false.
+    public var provenance: Bool {
+        get {
+            return tessGetProvenance(_tess)
+        }
+        set {
+            tessSetProvenance(_tess, newValue)
+        }
+    }
+    
+    /// Whether tesselations compute the bounding box, centroid and area of
+    /// each `.polygons`, `.connectedPolygons` or `.boundaryContours` element
+    /// into `elementMetrics`, while writing the output.
+    /// Defaults to false.
+    public var computeElementMetrics: Bool {
+        get {
+            return tessGetElementMetrics(_tess)
+        }
+        set {
+            tessSetElementMetrics(_tess, newValue)
+        }
+    }
+    
+    /// Whether each tesselation appends its output to that of the previous
+    /// ones, so that many shapes share one vertex and index buffer. Indices
+    /// refer to the shared vertices, and each call's part is listed in
+    /// `drawRanges`. Supported for `.polygons`, `.triangleStrips` and
+    /// `.triangleFans` with a constant `polySize` and vertex size;
+    /// `tessellate(into:...)` throws while it is set.
+    /// Changing it clears the output.
+    /// Defaults to false.
+    public var appendOutput: Bool {
+        get {
+            return tessGetAppendOutput(_tess)
+        }
+        set {
+            tessSetAppendOutput(_tess, newValue)
+        }
+    }
+    
+    /// The part of the output added by each tesselation since the output
+    /// was last cleared, see `appendOutput`.
+    public var drawRanges: [TESSdrawRange] {
+        return Array(UnsafeBufferPointer(start: tessGetDrawRanges(_tess), count: Int(tessGetDrawRangeCount(_tess))))
+    }
+    
+    /// Maximum number of vertices per meshlet in `.meshlets` output, at
+    /// most 256.
+    /// Defaults to 64.
+    public var meshletMaxVertices: Int {
+        get {
+            return Int(tessGetMeshletMaxVertices(_tess))
+        }
+        set {
+            tessSetMeshletLimits(_tess, Int32(newValue), Int32(meshletMaxTriangles))
+        }
+    }
+    
+    /// Maximum number of triangles per meshlet in `.meshlets` output, at
+    /// most 512.
+    /// Defaults to 126.
+    public var meshletMaxTriangles: Int {
+        get {
+            return Int(tessGetMeshletMaxTriangles(_tess))
+        }
+        set {
+            tessSetMeshletLimits(_tess, Int32(meshletMaxVertices), Int32(newValue))
+        }
+    }
+    
+    /// Called for every vertex the tesselator creates where two edges
+    /// intersect, similar to GLU's `GLU_TESS_COMBINE`.
+    ///
+    /// - parents: the indices of the four vertices the new vertex is
+    /// interpolated from, numbered in the order they were added. A parent
+    /// which was itself created at an intersection has the index this
+    /// closure returned for it, or -1.
+    /// - weights: the interpolation weights of the parents.
+    /// - coords: the coordinates of the new vertex, already interpolated
+    /// linearly from the parents. May be modified.
+    ///
+    /// The returned index is reported for the new vertex in `vertexIndices`,
+    /// so attributes that need non-linear interpolation can be kept in
+    /// buffers outside the tesselator. Returning nil reports -1.
+    public var combineCallback: CombineCallback? {
+        didSet {
+            if combineCallback == nil {
+                tessSetCombineCallback(_tess, nil, nil)
+            } else {
+                tessSetCombineCallback(_tess, combineThunk, Unmanaged.passUnretained(self).toOpaque())
+            }
+        }
+    }
+    
+    /// When set, `.polygons` output is passed to this closure instead of
+    /// being stored: each region is passed on as triangles as soon as it has
+    /// been triangulated, and then freed. `polySize` is ignored and the
+    /// tessellate calls return empty results. The regions are triangulated
+    /// once the sweep has finished, so this saves the output arrays, not the
+    /// memory held by the swept mesh.
+    ///
+    /// - vertices: the coordinates of the 3 vertices, `vertexSize` per vertex.
+    /// - vertexIndices: the indices of the 3 vertices, as in `vertexIndices`.
+    public var triangleCallback: TriangleCallback? {
+        didSet {
+            if triangleCallback == nil {
+                tessSetTriangleCallback(_tess, nil, nil)
+            } else {
+                tessSetTriangleCallback(_tess, triangleThunk, Unmanaged.passUnretained(self).toOpaque())
+            }
+        }
+    }
+    
     /// List of vertices tesselated.
     ///
     /// Is nil, until a tesselation (CVector3-variant) is performed.
@@ -96,6 +371,14 @@ open class TessC {
     /// Is nil, until a tesselation (any variant) is performed.
     public var verticesRaw: [TESSreal]?
     
+    /// For each tesselated vertex, the index of the input vertex it comes
+    /// from, numbered in the order vertices were added, or the index returned
+    /// by `combineCallback` for vertices created at intersections (-1 if
+    /// there is none).
+    ///
+    /// Is nil, until a tesselation is performed.
+    public var vertexIndices: [Int]?
+    
     /// List of elements tesselated.
     ///
     /// Is nil, until a tesselation is performed.
@@ -111,6 +394,40 @@ open class TessC {
     /// Is 0, until a tesselation is performed.
     public var elementCount: Int = 0
     
+    /// Meshlets of the last `.meshlets` tesselation; their triangles are
+    /// also listed, in the same order, in `elements`.
+    ///
+    /// Is nil, until a tesselation with `.meshlets` is performed.
+    public var meshlets: [Meshlet]?
+    
+    /// For each edge of the last `.edges` tesselation, whether it is on the
+    /// boundary of the polygons rather than shared by two of them. Boundary
+    /// edges have the polygons on their left.
+    ///
+    /// Is nil, until a tesselation with `.edges` is performed.
+    public var boundaryEdges: [Bool]?
+    
+    /// For each element, the contour of the nearest input edge above it in
+    /// the sweep direction, or -1. Below a hole this is the hole's contour.
+    ///
+    /// Is nil, unless `provenance` is set and the last tesselation produced
+    /// `.polygons`, `.connectedPolygons` or `.boundaryContours`.
+    public var elementContours: [Int]?
+    
+    /// The contour of the input edge each output edge lies on, or -1 for
+    /// edges added by the tesselation: `polySize` entries per polygon, the
+    /// edge from vertex j to vertex j + 1 at entry j, or one per vertex of
+    /// `.boundaryContours`, for the edge starting at it.
+    ///
+    /// Is nil under the same conditions as `elementContours`.
+    public var edgeContours: [Int]?
+    
+    /// Metrics of each element, in input coordinates.
+    ///
+    /// Is nil, unless `computeElementMetrics` is set and the last tesselation
+    /// produced `.polygons`, `.connectedPolygons` or `.boundaryContours`.
+    public var elementMetrics: [ElementMetrics]?
+    
     /// Tries to init this tesselator
     /// Optionally specifies whether to use memory pooling, and the memory size
     /// of the pool.
@@ -228,6 +545,9 @@ open class TessC {
     /// This variant of `tesselate` returns the raw set of vertices on `vertices`.
     /// `vertices` will always be `% vertexSize` count of elements.
     ///
+    /// For `.triangleStrips` and `.triangleFans` the indices of all strips
+    /// (or fans) are returned back to back, each one terminated by -1.
+    ///
     /// - Parameters:
     ///   - windingRule: Winding rule for tesselation.
     ///   - elementType: Type of elements contained in the contours buffer.
@@ -246,6 +566,7 @@ open class TessC {
         // Fetch tesselation out
         tessGetElements(_tess)
         let verts = _tess.pointee.vertices!
+        let vertIndices = _tess.pointee.vertexIndices!
         let elems = _tess.pointee.elements!
         let nverts = Int(_tess.pointee.vertexCount)
         let nelems = Int(_tess.pointee.elementCount)
@@ -258,18 +579,48 @@ open class TessC {
         }
         var indicesOut: [Int] = []
         
-        for i in 0..<nelems {
-            let p = elems.advanced(by: i * polySize)
-            for j in 0..<polySize where p[j] != ~TESSindex() {
-                indicesOut.append(Int(p[j]))
+        switch elementType {
+        case .triangleStrips, .triangleFans:
+            let nindices = Int(tessGetIndexCount(_tess))
+            indicesOut = (0..<nindices).map { elems[$0] == ~TESSindex() ? -1 : Int(elems[$0]) }
+        case .meshlets:
+            indicesOut = (0..<nelems * 3).map { Int(elems[$0]) }
+        case .edges:
+            indicesOut = (0..<nelems * 3).filter { $0 % 3 != 2 }.map { Int(elems[$0]) }
+        case .trapezoids:
+            indicesOut = (0..<nelems * 4).map { Int(elems[$0]) }
+        default:
+            for i in 0..<nelems {
+                let p = elems.advanced(by: i * polySize)
+                for j in 0..<polySize where p[j] != ~TESSindex() {
+                    indicesOut.append(Int(p[j]))
+                }
             }
         }
         
         verticesRaw = output
+        vertexIndices = (0..<nverts).map { Int(vertIndices[$0]) }
         vertexCount = nverts
         elementCount = nelems
         
         elements = indicesOut
+        meshlets = elementType == .meshlets ? fetchMeshlets() : nil
+        boundaryEdges = elementType == .edges ? (0..<nelems).map { elems[$0 * 3 + 2] != 0 } : nil
+        
+        if provenance && [.polygons, .connectedPolygons, .boundaryContours].contains(elementType) {
+            let nedges = elementType == .boundaryContours ? nverts : nelems * polySize
+            elementContours = (0..<nelems).map { Int(tessGetElementContours(_tess)[$0]) }
+            edgeContours = (0..<nedges).map { Int(tessGetEdgeContours(_tess)[$0]) }
+        } else {
+            elementContours = nil
+            edgeContours = nil
+        }
+        
+        if computeElementMetrics && [.polygons, .connectedPolygons, .boundaryContours].contains(elementType) {
+            elementMetrics = fetchElementMetrics(count: nelems)
+        } else {
+            elementMetrics = nil
+        }
         
         return (output, indicesOut)
     }
@@ -310,6 +661,141 @@ open class TessC {
         return (output, i)
     }
     
+    /// Tesselates straight into caller owned buffers described by `layout`,
+    /// skipping the copies `tessellateRaw` makes into Swift arrays.
+    /// The properties of this `TessC` (`vertices`, `elements`, etc.) are not
+    /// updated.
+    ///
+    /// `layout.vertexCount`, `layout.elementCount` and `layout.indexCount`
+    /// are always set to the size of the output, so they can be used to grow
+    /// the buffers when they are too small.
+    ///
+    /// With `layout.vertexFormat` set to `TESS_VERTEX_INT16` the coordinates
+    /// are quantized, and `layout.dequantScale` and `layout.dequantOffset`
+    /// hold the transform that restores them.
+    ///
+    /// Throws while `appendOutput` is set, keeping the appended output.
+    ///
+    /// - Parameters:
+    ///   - layout: Destination buffers, their strides and index type.
+    ///   - windingRule: Winding rule for tesselation.
+    ///   - elementType: Type of elements contained in the contours buffer.
+    ///   - polySize: Defines maximum vertices per polygons if output is polygons.
+    ///   - vertexSize: Number of coordinates written per vertex.
+    /// - Returns: `true` if the output was written to the buffers, `false` if
+    /// they are too small.
+    @discardableResult
+    open func tessellate(into layout: inout TESSoutputLayout, windingRule: WindingRule, elementType: ElementType, polySize: Int, vertexSize: Int = 3) throws -> Bool {
+        
+        let result = _tess.pointee.tesselate(windingRule: Int32(windingRule.rawValue), elementType: Int32(elementType.rawValue), polySize: Int32(polySize),
+                                             vertexSize: Int32(vertexSize), normal: nil, layout: &layout)
+        if result == 0 {
+            throw TessError.tesselationFailed
+        }
+        
+        return result == 1
+    }
+    
+    /// Empties the accumulated output of `appendOutput` mode.
+    open func clearOutput() {
+        tessClearOutput(_tess)
+    }
+    
+    /// Tesselates, and transfers the output to a `TessResult` without copying
+    /// it. The properties of this `TessC` (`vertices`, `elements`, etc.) are
+    /// not updated.
+    ///
+    /// - Parameters:
+    ///   - windingRule: Winding rule for tesselation.
+    ///   - elementType: Type of elements contained in the contours buffer.
+    ///   - polySize: Defines maximum vertices per polygons if output is polygons.
+    ///   - vertexSize: Number of coordinates per output vertex.
+    open func tessellateDetached(windingRule: WindingRule, elementType: ElementType, polySize: Int, vertexSize: Int = 3) throws -> TessResult {
+        
+        if(_tess.pointee.tesselate(windingRule: Int32(windingRule.rawValue), elementType: Int32(elementType.rawValue), polySize: Int32(polySize),
+            vertexSize: Int32(vertexSize), normal: nil) == 0) {
+            throw TessError.tesselationFailed
+        }
+        
+        guard let result = tessDetachResult(_tess) else {
+            throw TessError.tesselationFailed
+        }
+        
+        return TessResult(result: result, elementType: elementType, polySize: polySize, vertexSize: vertexSize)
+    }
+    
+    /// Renders the added contours into a coverage mask without tesselating
+    /// them, and discards them as tesselating does. The coverage of each
+    /// pixel, 0 to 255, is added to it, saturating, so shapes can be
+    /// accumulated into one mask. Contours are projected onto the xy plane.
+    ///
+    /// - Parameters:
+    ///   - mask: `height` rows of `width` pixels.
+    ///   - width: Width of the mask in pixels.
+    ///   - height: Height of the mask in pixels.
+    ///   - windingRule: Winding rule deciding what is inside the contours.
+    ///   - viewBox: Minimum x, minimum y, maximum x and maximum y of the area
+    /// mapped onto the mask, with row 0 at minimum y. Defaults to the bounds
+    /// of the contours.
+    ///   - samples: Scanlines per row of pixels; coverage along the scanlines
+    /// is exact.
+    open func rasterize(into mask: inout [UInt8], width: Int, height: Int, windingRule: WindingRule, viewBox: [TESSreal]? = nil, samples: Int = 4) throws {
+        precondition(mask.count >= width * height, "Mask is smaller than width * height")
+        precondition(viewBox == nil || viewBox!.count == 4, "View box must have 4 values")
+        
+        if mask.isEmpty {
+            _tess.pointee.reset()
+            return
+        }
+        
+        let box = viewBox ?? []
+        let result = mask.withUnsafeMutableBufferPointer { m in
+            box.withUnsafeBufferPointer { b in
+                _tess.pointee.rasterize(windingRule: Int32(windingRule.rawValue), mask: m.baseAddress!,
+                                        width: Int32(width), height: Int32(height), stride: Int32(width),
+                                        viewBox: box.isEmpty ? nil : b.baseAddress, samples: Int32(samples))
+            }
+        }
+        if result == 0 {
+            throw TessError.tesselationFailed
+        }
+    }
+
+    private func fetchElementMetrics(count: Int) -> [ElementMetrics] {
+        func metric(_ m: TessElementMetric) -> UnsafePointer<TESSreal> {
+            return tessGetElementMetric(_tess, Int32(m.rawValue))
+        }
+        
+        let minX = metric(TESS_METRIC_MIN_X), minY = metric(TESS_METRIC_MIN_Y), minZ = metric(TESS_METRIC_MIN_Z)
+        let maxX = metric(TESS_METRIC_MAX_X), maxY = metric(TESS_METRIC_MAX_Y), maxZ = metric(TESS_METRIC_MAX_Z)
+        let cx = metric(TESS_METRIC_CENTROID_X), cy = metric(TESS_METRIC_CENTROID_Y), cz = metric(TESS_METRIC_CENTROID_Z)
+        let area = metric(TESS_METRIC_AREA)
+        
+        return (0..<count).map { i in
+            ElementMetrics(boundsMin: CVector3(x: minX[i], y: minY[i], z: minZ[i]),
+                           boundsMax: CVector3(x: maxX[i], y: maxY[i], z: maxZ[i]),
+                           centroid: CVector3(x: cx[i], y: cy[i], z: cz[i]),
+                           area: area[i])
+        }
+    }
+    
+    private func fetchMeshlets() -> [Meshlet] {
+        let meshlets = tessGetMeshlets(_tess)
+        let vertices = tessGetMeshletVertices(_tess)
+        let triangles = tessGetMeshletTriangles(_tess)
+        
+        return (0..<Int(tessGetMeshletCount(_tess))).map { i in
+            let m = meshlets[i]
+            let vertexOffset = Int(m.vertexOffset)
+            let triangleOffset = Int(m.triangleOffset) * 3
+            
+            return Meshlet(vertices: (0..<Int(m.vertexCount)).map { Int(vertices[vertexOffset + $0]) },
+                           triangles: Array(UnsafeBufferPointer(start: triangles + triangleOffset, count: Int(m.triangleCount) * 3)),
+                           boundsMin: CVector3(x: m.bmin.0, y: m.bmin.1, z: m.bmin.2),
+                           boundsMax: CVector3(x: m.bmax.0, y: m.bmax.1, z: m.bmax.2))
+        }
+    }
+    
     private func signedArea(_ vertices: [CVector3]) -> TESSreal {
         var area: TESSreal = 0.0
         
@@ -324,6 +810,10 @@ open class TessC {
         return 0.5 * area
     }
     
+    public typealias CombineCallback = (_ parents: [Int], _ weights: [TESSreal], _ coords: inout [TESSreal]) -> Int?
+    
+    public typealias TriangleCallback = (_ vertices: [TESSreal], _ vertexIndices: [Int]) -> Void
+    
     public enum TessError: Error {
         /// Error when a tessTesselate() call fails.
         case tesselationFailed
@@ -419,3 +909,48 @@ public extension TessC {
         return (tess.vertices!, indices)
     }
 }
+
+/// Forwards libtess2's combine callback to `TessC.combineCallback`.
+/// `userData` is the unretained `TessC` instance.
+private func combineThunk(userData: UnsafeMutableRawPointer?,
+                          parents: UnsafePointer<TESSindex>,
+                          weights: UnsafePointer<TESSreal>,
+                          coords: UnsafeMutablePointer<TESSreal>,
+                          size: Int32) -> TESSindex {
+    
+    guard let userData = userData else {
+        return ~0
+    }
+    let tess = Unmanaged<TessC>.fromOpaque(userData).takeUnretainedValue()
+    guard let callback = tess.combineCallback else {
+        return ~0
+    }
+    
+    var values = Array(UnsafeBufferPointer(start: coords, count: Int(size)))
+    let index = callback((0..<4).map { Int(parents[$0]) }, (0..<4).map { weights[$0] }, &values)
+    
+    for i in 0..<min(values.count, Int(size)) {
+        coords[i] = values[i]
+    }
+    
+    return index.map { TESSindex($0) } ?? ~0
+}
+
+/// Forwards libtess2's triangle callback to `TessC.triangleCallback`.
+/// `userData` is the unretained `TessC` instance.
+private func triangleThunk(userData: UnsafeMutableRawPointer?,
+                           vertices: UnsafePointer<TESSreal>,
+                           vertexIndices: UnsafePointer<TESSindex>,
+                           size: Int32) {
+    
+    guard let userData = userData else {
+        return
+    }
+    let tess = Unmanaged<TessC>.fromOpaque(userData).takeUnretainedValue()
+    guard let callback = tess.triangleCallback else {
+        return
+    }
+    
+    callback(Array(UnsafeBufferPointer(start: vertices, count: 3 * Int(size))),
+             (0..<3).map { Int(vertexIndices[$0]) })
+}
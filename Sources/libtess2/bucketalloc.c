@@ -53,26 +53,13 @@ struct BucketAlloc
 	TESSalloc* alloc;
 };
 
-static int CreateBucket( struct BucketAlloc* ba )
+static void AddBucketItems( struct BucketAlloc* ba, Bucket* bucket )
 {
-	size_t size;
-	Bucket* bucket;
 	void* freelist;
 	unsigned char* head;
 	unsigned char* it;
 
-	// Allocate memory for the bucket
-	size = sizeof(Bucket) + ba->itemSize * ba->bucketSize;
-	bucket = (Bucket*)ba->alloc->memalloc( ba->alloc->userData, size );
-	if ( !bucket )
-		return 0;
-	bucket->next = 0;
-
-	// Add the bucket into the list of buckets.
-	bucket->next = ba->buckets;
-	ba->buckets = bucket;
-
-	// Add new items to the free list.
+	// Add the bucket's items into the free list.
 	freelist = ba->freelist;
 	head = (unsigned char*)bucket + sizeof(Bucket);
 	it = head + ba->itemSize * ba->bucketSize;
@@ -87,6 +74,25 @@ static int CreateBucket( struct BucketAlloc* ba )
 	while ( it != head );
 	// Update pointer to next location containing a free item.
 	ba->freelist = (void*)it;
+}
+
+static int CreateBucket( struct BucketAlloc* ba )
+{
+	size_t size;
+	Bucket* bucket;
+
+	// Allocate memory for the bucket
+	size = sizeof(Bucket) + ba->itemSize * ba->bucketSize;
+	bucket = (Bucket*)ba->alloc->memalloc( ba->alloc->userData, size );
+	if ( !bucket )
+		return 0;
+	bucket->next = 0;
+
+	// Add the bucket into the list of buckets.
+	bucket->next = ba->buckets;
+	ba->buckets = bucket;
+
+	AddBucketItems( ba, bucket );
 
 	return 1;
 }
@@ -174,6 +180,17 @@ void bucketFree( struct BucketAlloc *ba, void *ptr )
 #endif
 }
 
+void bucketReset( struct BucketAlloc *ba )
+{
+	Bucket *bucket;
+
+	// Put every item back on the free list, keeping the buckets. The
+	// newest bucket is listed first, so the oldest one ends up in front.
+	ba->freelist = 0;
+	for ( bucket = ba->buckets; bucket; bucket = bucket->next )
+		AddBucketItems( ba, bucket );
+}
+
 void deleteBucketAlloc( struct BucketAlloc *ba )
 {
 	TESSalloc* alloc = ba->alloc;
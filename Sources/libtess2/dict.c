@@ -34,28 +34,101 @@
 #include "bucketalloc.h"
 #include "dict.h"
 
-/* really tessDictListNewDict */
-Dict *dictNewDict( TESSalloc* alloc, void *frame, int (*leq)(void *frame, DictKey key1, DictKey key2) )
+/* Each skip list level keeps roughly one in four nodes of the level below. */
+#define SKIP_P_SHIFT	2
+
+static int RandomHeight( Dict *dict )
 {
-	Dict *dict = (Dict *)alloc->memalloc( alloc->userData, sizeof( Dict ));
-	DictNode *head;
+	unsigned int x = dict->seed;
+	int h = 1;
 
-	if (dict == NULL) return NULL;
+	/* xorshift32, deterministic so that runs are reproducible */
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	dict->seed = x;
+
+	while( h < DICT_MAX_LEVEL && (x & ((1u << SKIP_P_SHIFT) - 1)) == 0 ) {
+		x >>= SKIP_P_SHIFT;
+		++h;
+	}
+	return h;
+}
 
-	head = &dict->head;
+#define LinkNext(n,i)	((i) == 0 ? (n)->next : (n)->up[(i)-1].next)
+#define LinkPrev(n,i)	((i) == 0 ? (n)->prev : (n)->up[(i)-1].prev)
+
+static int CreatePool( Dict *dict, int height )
+{
+	int size;
+
+	/* Taller towers are exponentially rarer, so they get smaller buckets. */
+	size = dict->alloc->dictNodeBucketSize >> (SKIP_P_SHIFT * (height-1));
+	if (size < 16)
+		size = 16;
+	dict->nodePool[height-1] = createBucketAlloc( dict->alloc, "Dict",
+		sizeof(DictNode) + (height-1) * sizeof(DictLink), size );
+	return dict->nodePool[height-1] != NULL;
+}
+
+static DictNode *AllocNode( Dict *dict, int height )
+{
+	DictNode *node;
+
+	if( dict->nodePool[height-1] == NULL && ! CreatePool( dict, height ))
+		return NULL;
+	node = (DictNode *)bucketAlloc( dict->nodePool[height-1] );
+	if (node == NULL) return NULL;
+
+	node->height = height;
+	node->up = (DictLink *)(node + 1);
+	return node;
+}
+
+static void InitHead( Dict *dict, int type )
+{
+	DictNode *head = &dict->head;
+	int i;
 
 	head->key = NULL;
 	head->next = head;
 	head->prev = head;
+	head->height = DICT_MAX_LEVEL;
+	head->up = dict->headUp;
+	for( i = 0; i < DICT_MAX_LEVEL-1; ++i ) {
+		dict->headUp[i].next = head;
+		dict->headUp[i].prev = head;
+	}
 
+	dict->type = type;
+	dict->level = 1;
+	dict->seed = 0x9e3779b9;
+	dict->finger = head;
+}
+
+/* really tessDictListNewDict */
+Dict *dictNewDict( TESSalloc* alloc, void *frame, int type, int (*leq)(void *frame, DictKey key1, DictKey key2) )
+{
+	Dict *dict = (Dict *)alloc->memalloc( alloc->userData, sizeof( Dict ));
+	int i;
+
+	if (dict == NULL) return NULL;
+
+	InitHead( dict, type );
 	dict->frame = frame;
+	dict->alloc = alloc;
 	dict->leq = leq;
 
 	if (alloc->dictNodeBucketSize < 16)
 		alloc->dictNodeBucketSize = 16;
 	if (alloc->dictNodeBucketSize > 4096)
 		alloc->dictNodeBucketSize = 4096;
-	dict->nodePool = createBucketAlloc( alloc, "Dict", sizeof(DictNode), alloc->dictNodeBucketSize );
+	for( i = 0; i < DICT_MAX_LEVEL; ++i )
+		dict->nodePool[i] = NULL;
+	if( ! CreatePool( dict, 1 )) {
+		alloc->memfree( alloc->userData, dict );
+		return NULL;
+	}
 
 	return dict;
 }
@@ -63,20 +136,41 @@ Dict *dictNewDict( TESSalloc* alloc, void *frame, int (*leq)(void *frame, DictKe
 /* really tessDictListDeleteDict */
 void dictDeleteDict( TESSalloc* alloc, Dict *dict )
 {
-	deleteBucketAlloc( dict->nodePool );
+	int i;
+
+	for( i = 0; i < DICT_MAX_LEVEL; ++i ) {
+		if( dict->nodePool[i] != NULL )
+			deleteBucketAlloc( dict->nodePool[i] );
+	}
 	alloc->memfree( alloc->userData, dict );
 }
 
+/* Empties the dictionary but keeps the node pools, so that it can be
+* refilled without allocating.  Tower heights restart from the same seed.
+*/
+void dictReset( Dict *dict, int type )
+{
+	int i;
+
+	for( i = 0; i < DICT_MAX_LEVEL; ++i ) {
+		if( dict->nodePool[i] != NULL )
+			bucketReset( dict->nodePool[i] );
+	}
+	InitHead( dict, type );
+}
+
 /* really tessDictListInsertBefore */
 DictNode *dictInsertBefore( Dict *dict, DictNode *node, DictKey key )
 {
-	DictNode *newNode;
+	DictNode *newNode, *p;
+	int height, i;
 
 	do {
 		node = node->prev;
 	} while( node->key != NULL && ! (*dict->leq)(dict->frame, node->key, key));
 
-	newNode = (DictNode *)bucketAlloc( dict->nodePool );
+	height = (dict->type == TESS_DICT_SKIPLIST) ? RandomHeight( dict ) : 1;
+	newNode = AllocNode( dict, height );
 	if (newNode == NULL) return NULL;
 
 	newNode->key = key;
@@ -85,21 +179,95 @@ DictNode *dictInsertBefore( Dict *dict, DictNode *node, DictKey key )
 	newNode->prev = node;
 	node->next = newNode;
 
+	/* Link the tower: the predecessor on level i is the closest node
+	* before us on level i-1 which is tall enough.  The head is as tall
+	* as any tower (its links live in dict->headUp), so the walk always
+	* terminates.
+	*/
+	p = node;
+	for( i = 1; i < height; ++i ) {
+		while( p->height <= i )
+			p = LinkPrev( p, i-1 );
+		newNode->up[i-1].next = p->up[i-1].next;
+		newNode->up[i-1].prev = p;
+		p->up[i-1].next->up[i-1].prev = newNode;
+		p->up[i-1].next = newNode;
+	}
+	if( height > dict->level )
+		dict->level = height;
+
+	dict->finger = newNode;
 	return newNode;
 }
 
 /* really tessDictListDelete */
 void dictDelete( Dict *dict, DictNode *node ) /*ARGSUSED*/
 {
+	int i;
+
+	for( i = 1; i < node->height; ++i ) {
+		node->up[i-1].next->up[i-1].prev = node->up[i-1].prev;
+		node->up[i-1].prev->up[i-1].next = node->up[i-1].next;
+	}
 	node->next->prev = node->prev;
 	node->prev->next = node->next;
-	bucketFree( dict->nodePool, node );
+	if( dict->finger == node )
+		dict->finger = node->prev;
+	bucketFree( dict->nodePool[node->height-1], node );
+}
+
+/* Descends the skip list from level 'i' starting at 'node', which must
+* precede the result.  Returns the first node whose key is >= key.
+*/
+static DictNode *SearchFrom( Dict *dict, DictNode *node, int i, DictKey key )
+{
+	DictNode *next;
+
+	for( ; i >= 0; --i ) {
+		for( ;; ) {
+			next = LinkNext( node, i );
+			if( next->key == NULL || (*dict->leq)(dict->frame, key, next->key) )
+				break;
+			node = next;
+		}
+	}
+	return node->next;
 }
 
 /* really tessDictListSearch */
 DictNode *dictSearch( Dict *dict, DictKey key )
 {
 	DictNode *node = &dict->head;
+	DictNode *next;
+	int i;
+
+	if( dict->type == TESS_DICT_SKIPLIST ) {
+		/* Finger search: sweep events are spatially coherent, so the
+		* answer is usually close to the last node we touched.  When the
+		* finger lies before the key, climb its tower until the next
+		* node on the current level would overshoot, then descend.
+		*/
+		node = dict->finger;
+		if( node->key == NULL || (*dict->leq)(dict->frame, key, node->key) )
+			return dict->finger = SearchFrom( dict, &dict->head, dict->level-1, key );
+
+		i = 0;
+		for( ;; ) {
+			if( i+1 < node->height ) {
+				next = LinkNext( node, i+1 );
+				if( next->key != NULL && ! (*dict->leq)(dict->frame, key, next->key) ) {
+					node = next;
+					++i;
+					continue;
+				}
+			}
+			next = LinkNext( node, i );
+			if( next->key == NULL || (*dict->leq)(dict->frame, key, next->key) )
+				break;
+			node = next;
+		}
+		return dict->finger = SearchFrom( dict, node, i, key );
+	}
 
 	do {
 		node = node->next;
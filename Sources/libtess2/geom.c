@@ -158,6 +158,22 @@ int tesvertCCW( TESSvertex *u, TESSvertex *v, TESSvertex *w )
 	return (u->s*(v->t - w->t) + v->s*(w->t - u->t) + w->s*(u->t - v->t)) >= 0;
 }
 
+int tesvertInCircle( TESSvertex *u, TESSvertex *v, TESSvertex *w, TESSvertex *x )
+{
+	/* Returns TRUE if x lies strictly inside the circle through u, v and w,
+	* which must be in CCW order.  Coordinates are taken relative to x, in
+	* double precision, which is exact for small integer coordinates; as
+	* for VertCCW, nearly cocircular points give unreliable results.
+	*/
+	double us = u->s - x->s, ut = u->t - x->t;
+	double vs = v->s - x->s, vt = v->t - x->t;
+	double ws = w->s - x->s, wt = w->t - x->t;
+
+	return (us*us + ut*ut) * (vs*wt - ws*vt)
+		 + (vs*vs + vt*vt) * (ws*ut - us*wt)
+		 + (ws*ws + wt*wt) * (us*vt - vs*ut) > 0;
+}
+
 /* Given parameters a,x,b,y returns the value (b*x+a*y)/(a+b),
 * or (x+y)/2 if a==b==0.  It requires that a,b >= 0, and enforces
 * this in the rare case that one argument is slightly negative.
@@ -67,6 +67,7 @@
 #define VertL1dist(u,v) (ABS(u->s - v->s) + ABS(u->t - v->t))
 
 #define VertCCW(u,v,w) tesvertCCW(u,v,w)
+#define VertInCircle(u,v,w,x) tesvertInCircle(u,v,w,x)
 
 int tesvertLeq( TESSvertex *u, TESSvertex *v );
 TESSreal	tesedgeEval( TESSvertex *u, TESSvertex *v, TESSvertex *w );
@@ -74,6 +75,7 @@ TESSreal	tesedgeSign( TESSvertex *u, TESSvertex *v, TESSvertex *w );
 TESSreal	testransEval( TESSvertex *u, TESSvertex *v, TESSvertex *w );
 TESSreal	testransSign( TESSvertex *u, TESSvertex *v, TESSvertex *w );
 int tesvertCCW( TESSvertex *u, TESSvertex *v, TESSvertex *w );
+int tesvertInCircle( TESSvertex *u, TESSvertex *v, TESSvertex *w, TESSvertex *x );
 void tesedgeIntersect( TESSvertex *o1, TESSvertex *d1, TESSvertex *o2, TESSvertex *d2, TESSvertex *v );
 
 #endif
@@ -42,6 +42,7 @@ struct BucketAlloc *createBucketAlloc( TESSalloc* alloc, const char *name,
 									  unsigned int itemSize, unsigned int bucketSize );
 void *bucketAlloc( struct BucketAlloc *ba);
 void bucketFree( struct BucketAlloc *ba, void *ptr );
+void bucketReset( struct BucketAlloc *ba );
 void deleteBucketAlloc( struct BucketAlloc *ba );
 
 #ifdef __cplusplus
@@ -36,9 +36,15 @@ typedef void *DictKey;
 typedef struct Dict Dict;
 typedef struct DictNode DictNode;
 
-Dict *dictNewDict( TESSalloc* alloc, void *frame, int (*leq)(void *frame, DictKey key1, DictKey key2) );
+/* The dictionary is always threaded as a sorted doubly-linked list, so
+* dictSucc/dictPred/dictMin/dictMax are O(1).  With TESS_DICT_SKIPLIST the
+* nodes additionally carry a skip list tower which lets dictSearch find
+* its node in O(log n) calls to leq instead of O(n).
+*/
+Dict *dictNewDict( TESSalloc* alloc, void *frame, int type, int (*leq)(void *frame, DictKey key1, DictKey key2) );
 
 void dictDeleteDict( TESSalloc* alloc, Dict *dict );
+void dictReset( Dict *dict, int type );
 
 /* Search returns the node with the smallest key greater than or equal
 * to the given key.  If there is no such key, returns a node whose
@@ -58,16 +64,33 @@ void dictDelete( Dict *dict, DictNode *node );
 
 /*** Private data structures ***/
 
+#define DICT_MAX_LEVEL	12
+
+typedef struct DictLink DictLink;
+
+struct DictLink {
+	DictNode *next;
+	DictNode *prev;
+};
+
 struct DictNode {
 	DictKey	key;
 	DictNode *next;
 	DictNode *prev;
+	int height;		/* number of levels this node is linked into, >= 1 */
+	DictLink *up;	/* links for levels 1..height-1, stored after the node */
 };
 
 struct Dict {
 	DictNode head;
+	DictLink headUp[DICT_MAX_LEVEL-1];
+	int type;
+	int level;		/* highest level currently in use */
+	unsigned int seed;
+	DictNode *finger;	/* last inserted or found node, hint for dictSearch */
 	void *frame;
-	struct BucketAlloc *nodePool;
+	TESSalloc *alloc;
+	struct BucketAlloc *nodePool[DICT_MAX_LEVEL];
 	int (*leq)(void *frame, DictKey key1, DictKey key2);
 };
 
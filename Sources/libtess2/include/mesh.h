@@ -112,11 +112,11 @@ struct TESSvertex {
 	TESShalfEdge *anEdge;    /* a half-edge with this origin */
 
 	/* Internal data (keep hidden) */
-	TESSreal coords[MAX_DIMENSIONS];  /* vertex location in 3D */
 	TESSreal s, t;       /* projection onto the sweep plane */
 	int pqHandle;   /* to allow deletion from priority queue */
 	TESSindex n;			/* to allow identify unique vertices */
 	TESSindex idx;			/* to allow map result to original verts */
+	TESSindex data;			/* row of the coordinates in tess->vertexData, or TESS_UNDEF */
 };
 
 struct TESSface {
@@ -129,6 +129,7 @@ struct TESSface {
 	TESSindex n;		/* to allow identiy unique faces */
 	char marked;     /* flag for conversion to strips */
 	char inside;     /* this face is in the polygon interior */
+	TESSindex contour;	/* contour of the nearest input edge above the region */
 };
 
 struct TESShalfEdge {
@@ -143,6 +144,7 @@ struct TESShalfEdge {
 	ActiveRegion *activeRegion;  /* a region with this upper edge (sweep.c) */
 	int winding;    /* change in winding number when crossing
 						  from the right face to the left face */
+	TESSindex contour;	/* tessAddContour() call the edge comes from, or TESS_UNDEF */
 };
 
 #define Rface   Sym->Lface
@@ -162,6 +164,10 @@ struct TESSmesh {
 	TESShalfEdge eHead;      /* dummy header for edge list */
 	TESShalfEdge eHeadSym;   /* and its symmetric counterpart */
 
+	int vertexCount;	/* number of vertices, faces and edge pairs, */
+	int faceCount;		/* kept up to date by the mesh operations */
+	int edgeCount;
+
 	struct BucketAlloc* edgeBucket;
 	struct BucketAlloc* vertexBucket;
 	struct BucketAlloc* faceBucket;
@@ -177,9 +183,10 @@ struct TESSmesh {
 * global list *before* the existing vertex or face (ie. e->Org or e->Lface).
 * This makes it easier to process all vertices or faces in the global lists
 * without worrying about processing the same data twice.  As a convenience,
-* when a face is split, the "inside" flag is copied from the old face.
-* Other internal data (v->data, v->activeRegion, f->data, f->marked,
-* f->trail, e->winding) is set to zero.
+* when a face is split, the "inside" flag and the contour are copied from
+* the old face.  Other internal data is cleared: v->data and e->contour
+* are set to TESS_UNDEF, and f->marked, f->trail, e->winding and
+* e->activeRegion to zero.
 *
 * ********************** Basic Edge Operations **************************
 *
@@ -224,6 +231,9 @@ struct TESSmesh {
 * and the newly created loop is eNew->Lface.  Otherwise, two disjoint
 * loops are merged into one, and the loop eDst->Lface is destroyed.
 *
+* tessMeshFlipEdge( eFlip ) replaces eFlip, the diagonal between two
+* triangles, by the other diagonal of their quadrilateral, in place.
+*
 * ************************ Other Operations *****************************
 *
 * tessMeshNewMesh() creates a new mesh with no edges, no vertices,
@@ -234,6 +244,13 @@ struct TESSmesh {
 *
 * tessMeshDeleteMesh( mesh ) will free all storage for any valid mesh.
 *
+* tessMeshResetMesh( mesh ) removes every vertex, face and edge but keeps
+* the storage, so that the mesh can be refilled without allocating.
+*
+* tessMeshMergeConvexFaces( mesh, maxVertsPerFace ) merges the inside
+* faces, which must all be triangles, into convex polygons of at most
+* maxVertsPerFace vertices.  Uses f->n of the faces as scratch.
+*
 * tessMeshZapFace( fZap ) destroys a face and removes it from the
 * global face list.  All edges of fZap will have a NULL pointer as their
 * left face.  Any edges which also have a NULL pointer as their right face
@@ -251,11 +268,13 @@ int tessMeshDelete( TESSmesh *mesh, TESShalfEdge *eDel );
 TESShalfEdge *tessMeshAddEdgeVertex( TESSmesh *mesh, TESShalfEdge *eOrg );
 TESShalfEdge *tessMeshSplitEdge( TESSmesh *mesh, TESShalfEdge *eOrg );
 TESShalfEdge *tessMeshConnect( TESSmesh *mesh, TESShalfEdge *eOrg, TESShalfEdge *eDst );
+void tessMeshFlipEdge( TESShalfEdge *eFlip );
 
 TESSmesh *tessMeshNewMesh( TESSalloc* alloc );
 TESSmesh *tessMeshUnion( TESSalloc* alloc, TESSmesh *mesh1, TESSmesh *mesh2 );
 int tessMeshMergeConvexFaces( TESSmesh *mesh, int maxVertsPerFace );
 void tessMeshDeleteMesh( TESSalloc* alloc, TESSmesh *mesh );
+void tessMeshResetMesh( TESSmesh *mesh );
 void tessMeshZapFace( TESSmesh *mesh, TESSface *fZap );
 TESSreal tessFaceArea( TESSface *face );
 
@@ -48,13 +48,19 @@
 
 /* Since we support deletion the data structure is a little more
 * complicated than an ordinary heap.  "nodes" is the heap itself;
-* active nodes are stored in the range 1..pq->size.  When the
-* heap exceeds its allocated size (pq->max), its size doubles.
-* The children of node i are nodes 2i and 2i+1.
+* active nodes are stored in the range 1..pq->size.  The heap is
+* 4-ary: the children of node i are nodes 4i-2 .. 4i+1.  Each node
+* keeps a copy of its vertex's (s,t), so sifting compares inline
+* values rather than calling through a function pointer and chasing
+* the key.
 *
 * Each node stores an index into an array "handles".  Each handle
 * stores a key, plus a pointer back to the node which currently
 * represents that key (ie. nodes[handles[i].node].handle == i).
+*
+* Nodes and handles live in fixed size chunks.  When the heap exceeds
+* its allocated size (pq->max) another chunk is added, so the heap
+* can grow even when the allocator has no memrealloc.
 */
 
 typedef void *PQkey;
@@ -63,18 +69,21 @@ typedef struct PriorityQHeap PriorityQHeap;
 
 #define INV_HANDLE 0x0fffffff
 
-typedef struct { PQhandle handle; } PQnode;
+#define PQ_CHUNK_SHIFT	8
+#define PQ_CHUNK_SIZE	(1 << PQ_CHUNK_SHIFT)
+#define PQ_CHUNK_MASK	(PQ_CHUNK_SIZE - 1)
+
+typedef struct { TESSreal s, t; PQhandle handle; } PQnode;
 typedef struct { PQkey key; PQhandle node; } PQhandleElem;
+typedef struct { PQnode nodes[PQ_CHUNK_SIZE]; PQhandleElem handles[PQ_CHUNK_SIZE]; } PQchunk;
 
 struct PriorityQHeap {
 
-	PQnode *nodes;
-	PQhandleElem *handles;
+	PQchunk **chunks;
+	int numChunks, maxChunks;
 	int size, max;
 	PQhandle freeList;
 	int initialized;
-
-	int (*leq)(PQkey key1, PQkey key2);
 };
 
 typedef struct PriorityQ PriorityQ;
@@ -85,6 +94,9 @@ struct PriorityQ {
 	PQkey *keys;
 	PQkey **order;
 	PQhandle size, max;
+	int keysMax, orderMax;	/* allocated lengths of keys and order */
+	struct SortItem *sortItems;	/* scratch space for sorting the keys */
+	int sortItemsMax;
 	int initialized;
 
 	int (*leq)(PQkey key1, PQkey key2);
@@ -92,6 +104,7 @@ struct PriorityQ {
 
 PriorityQ *pqNewPriorityQ( TESSalloc* alloc, int size, int (*leq)(PQkey key1, PQkey key2) );
 void pqDeletePriorityQ( TESSalloc* alloc, PriorityQ *pq );
+int pqReset( TESSalloc* alloc, PriorityQ *pq, int size );
 
 int pqInit( TESSalloc* alloc, PriorityQ *pq );
 PQhandle pqInsert( TESSalloc* alloc, PriorityQ *pq, PQkey key );
@@ -47,11 +47,22 @@ NS_ASSUME_NONNULL_BEGIN
 
 //typedef struct TESStesselator TESStesselator;
 
+/* How the coordinates of a vertex created at an intersection are
+* interpolated from its four parents.
+*/
+typedef struct TESSinterp {
+	TESSindex parents[4];	/* rows of the parents in vertexData, or TESS_UNDEF */
+	TESSreal weights[4];
+	int needed;		/* the vertex, or a descendant, is part of the output */
+	int resolved;	/* the row has been filled in */
+} TESSinterp;
+
 struct TESStesselator {
 
 	/*** state needed for collecting the input data ***/
 	TESSmesh	*_Nullable mesh;		/* stores the input contours, and eventually
 						the tessellation itself */
+	TESSmesh	*_Nullable spareMesh;	/* emptied mesh kept for reuse by tessReset() */
 	int outOfMemory;
 
 	/*** state needed for projecting onto the sweep plane ***/
@@ -71,22 +82,103 @@ struct TESStesselator {
 	TESSvertex *_Nullable event;		/* current sweep event being processed */
     
     bool noEmptyPolygons; /* Whether to avoid creating triangles with 0-area in output */
+	int dictType;		/* TessDictType used for the edge dictionary */
+	bool optimizeVertexCache;	/* reorder polygons for the post-transform cache */
+	bool delaunay;		/* see tessSetDelaunay() */
+	bool simpleContours;	/* see tessSetSimpleContours() */
+	bool simpleViolation;	/* see tessGetSimpleViolation() */
+	int meshletMaxVertices;		/* limits of TESS_MESHLETS clusters */
+	int meshletMaxTriangles;
 
 	struct BucketAlloc*_Nullable regionPool;
 
 	TESSindex vertexIndexCounter;
+	TESSindex contourCounter;	/* ID of the next tessAddContour() call */
+
+	/* A lone convex contour which tessAddContour() has stored in vertexData,
+	* but kept out of the mesh until another contour or an output needing
+	* the sweep comes along, see OutputConvexContour().
+	*/
+	int convexCount;	/* its vertices, 0 if there is none */
+	int convexFirst;	/* its first row in vertexData */
+	TESSindex convexIndex;	/* the vertex index of that row */
+	TESSindex convexContour;
+	bool provenance;	/* see tessSetProvenance() */
+	bool elementMetrics;	/* see tessSetElementMetrics() */
+
+	/* Vertex coordinates live in a side table rather than in TESSvertex,
+	* so that the mesh only carries what the sweep needs.  Each row holds
+	* vertexDataSize values (at least 3, the position), zero padded.
+	*/
+	TESSreal *_Nullable vertexData;
+	int vertexDataSize;
+	int vertexDataCount;
+	int vertexDataMax;
+
+	/* Rows of intersection vertices are only filled in, by
+	* tessResolveVertexData(), for vertices which survive into the output.
+	* interp[i] describes row interpBase + i.
+	*/
+	TESSinterp *_Nullable interp;
+	int interpBase;
+	int interpCount;
+	int interpMax;
+
+	TESScombineCallback _Nullable combine;	/* see tessSetCombineCallback() */
+	void *_Nullable combineUserData;
+
+	TESStriangleCallback _Nullable triangleCallback;	/* see tessSetTriangleCallback() */
+	void *_Nullable triangleUserData;
 	
 	TESSreal *_Nullable vertices;
 	TESSindex *_Nullable vertexIndices;
 	int vertexCount;
 	TESSindex *_Nullable elements;
 	int elementCount;
+	int indexCount;		/* number of entries in elements */
+
+	TESSindex *_Nullable elementContours;	/* see tessGetElementContours() */
+	TESSindex *_Nullable edgeContours;	/* see tessGetEdgeContours() */
+	TESSreal *_Nullable metrics;	/* TESS_METRIC_COUNT rows of metricsMax values */
+
+	bool appendOutput;	/* see tessSetAppendOutput() */
+	int vertexBase;		/* output of the previous calls, 0 unless appending */
+	int elementBase;
+	int indexBase;
+	TESSdrawRange *_Nullable drawRanges;
+	int drawRangeCount;
+
+	TESSmeshlet *_Nullable meshlets;	/* TESS_MESHLETS output, see tessGetMeshlets() */
+	int meshletCount;
+	TESSindex *_Nullable meshletVertices;
+	unsigned char *_Nullable meshletTriangles;
+
+	/* Allocated lengths of the output buffers, which are reused between
+	* calls to tessTesselate.
+	*/
+	int verticesMax;
+	int vertexIndicesMax;
+	int elementsMax;
+	int drawRangesMax;
+	int elementContoursMax;
+	int edgeContoursMax;
+	int metricsMax;
+	int meshletsMax;
+	int meshletVerticesMax;
+	int meshletTrianglesMax;
+
+	void *_Nullable scratch;	/* temporary memory for the output stages */
+	int scratchMax;
 
 	TESSalloc alloc;
 	
 	jmp_buf env;			/* place to jump to when memAllocs fail */
 } SWIFT_CLASS_NAMED("Tesselator");
 
+#define tessVertexData(tess,v)	(&(tess)->vertexData[(v)->data * (tess)->vertexDataSize])
+
+int tessReserveVertexData( TESStesselator *tess, int count );
+
 NS_ASSUME_NONNULL_END
 
 #ifdef __cplusplus
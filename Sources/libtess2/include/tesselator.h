@@ -129,11 +129,172 @@ enum TessWindingRule
 /// }
 /// \endcode
 ///
+/// \par TESS_TRIANGLE_STRIPS, TESS_TRIANGLE_FANS
+///
+///   The interior is covered with triangle strips (or fans). Each element is a run of vertex indices
+///   terminated by TESS_UNDEF, so the element array can be drawn with primitive restart enabled.
+///   The element array has tessGetIndexCount() entries, polySize is ignored.
+///   Example, drawing strips:
+///
+/// \code
+/// const int nindices = tessGetIndexCount(tess);
+/// const TESSindex* elems = tessGetElements(tess);
+/// glBegin(GL_TRIANGLE_STRIP);
+/// for (int i = 0; i < nindices; i++) {
+///     if (elems[i] == TESS_UNDEF) {
+///         glEnd();
+///         if (i + 1 < nindices) glBegin(GL_TRIANGLE_STRIP);
+///         continue;
+///     }
+///     glVertex2fv(&verts[elems[i] * vertexSize]);
+/// }
+/// \endcode
+///
+/// \par TESS_MESHLETS
+///
+///   The triangles are partitioned into meshlets, clusters of adjacent triangles with at most
+///   tessGetMeshletMaxVertices() vertices and tessGetMeshletMaxTriangles() triangles each, see
+///   tessSetMeshletLimits(). The element array holds the triangles as TESS_POLYGONS with polySize 3,
+///   grouped by meshlet; polySize is ignored. tessGetMeshlets() describes each meshlet.
+///   Example, drawing the triangles of a meshlet through its local index buffer:
+///
+/// \code
+/// const TESSmeshlet* m = &tessGetMeshlets(tess)[i];
+/// const TESSindex* mverts = tessGetMeshletVertices(tess) + m->vertexOffset;
+/// const unsigned char* mtris = tessGetMeshletTriangles(tess) + m->triangleOffset * 3;
+/// glBegin(GL_TRIANGLES);
+/// for (int j = 0; j < m->triangleCount * 3; j++)
+///     glVertex2fv(&verts[mverts[mtris[j]] * vertexSize]);
+/// glEnd();
+/// \endcode
+///
+/// \par TESS_EDGES
+///
+///   Each unique edge of the polygons which TESS_POLYGONS would output is stored once, as three
+///   entries: the indices of its two vertices, followed by 1 if the edge is on the boundary of the
+///   polygons and 0 if it is shared by two of them. Boundary edges are directed so that the polygons
+///   are on their left, as in TESS_BOUNDARY_CONTOURS. With polySize > 3 the triangles are first
+///   merged into convex polygons, as for TESS_POLYGONS.
+///   Example, drawing the outline over a wireframe:
+///
+/// \code
+/// const int nelems = tessGetElementCount(tess);
+/// const TESSindex* elems = tessGetElements(tess);
+/// glBegin(GL_LINES);
+/// for (int i = 0; i < nelems; i++) {
+///     const TESSindex* edge = &elems[i * 3];
+///     glColor3f(edge[2] ? 1 : 0.5f, 0, 0);
+///     glVertex2fv(&verts[edge[0] * vertexSize]);
+///     glVertex2fv(&verts[edge[1] * vertexSize]);
+/// }
+/// glEnd();
+/// \endcode
+///
+/// \par TESS_TRAPEZOIDS
+///
+///   The interior is cut into trapezoids straight from the monotone regions of the sweep, without
+///   triangulating them. Two sides of each trapezoid lie at a constant sweep coordinate, the other two
+///   on the edges of the region. Each element is four vertex indices in counter-clockwise order:
+///   lower left, lower right, upper right, upper left. Where a side has zero length its two corners
+///   share an index. Corners between the input vertices are new vertices, with TESS_UNDEF as their
+///   vertex index. For input in the xy plane the sweep runs along x, so the parallel sides are vertical;
+///   swap x and y to get horizontal spans. polySize is ignored.
+///   Example, filling the spans of a rasterizer:
+///
+/// \code
+/// const int nelems = tessGetElementCount(tess);
+/// const TESSindex* elems = tessGetElements(tess);
+/// for (int i = 0; i < nelems; i++) {
+///     const TESSindex* trap = &elems[i * 4];
+///     const float* lo0 = &verts[trap[0] * vertexSize];
+///     const float* lo1 = &verts[trap[1] * vertexSize];
+///     const float* up1 = &verts[trap[2] * vertexSize];
+///     const float* up0 = &verts[trap[3] * vertexSize];
+///     fillTrapezoid(lo0[0], lo1[0], lo0[1], lo1[1], up0[1], up1[1]);
+/// }
+/// \endcode
+///
 enum TessElementType
 {
     TESS_POLYGONS,
     TESS_CONNECTED_POLYGONS,
     TESS_BOUNDARY_CONTOURS,
+    TESS_TRIANGLE_STRIPS,
+    TESS_TRIANGLE_FANS,
+    TESS_MESHLETS,
+    TESS_EDGES,
+    TESS_TRAPEZOIDS,
+};
+
+/// Data structure used for the sweep line edge dictionary.
+///
+/// \par TESS_DICT_LIST
+///
+///   Sorted doubly-linked list. Locating the edge below each new vertex is O(n) in the number
+///   of edges crossing the sweep line, which is fine for small inputs.
+///
+/// \par TESS_DICT_SKIPLIST
+///
+///   Skip list threaded over the same sorted list, with finger search starting from the last
+///   located edge. Locating an edge is O(log n), which keeps large inputs with thousands of
+///   edges crossing the sweep line from going quadratic. This is the default.
+enum TessDictType
+{
+    TESS_DICT_LIST,
+    TESS_DICT_SKIPLIST,
+};
+
+/// Type of the indices written by tessTesselateInto().
+///
+/// \par TESS_INDEX_INT32
+///
+///   TESSindex, as returned by tessGetElements(). Unused entries are TESS_UNDEF.
+///
+/// \par TESS_INDEX_UINT16
+///
+///   unsigned short. Unused entries are 0xffff, so the output may have at most 65535 vertices, and
+///   TESS_CONNECTED_POLYGONS output, whose neighbour entries are face numbers, fewer than 65535 polygons.
+enum TessIndexType
+{
+    TESS_INDEX_INT32,
+    TESS_INDEX_UINT16,
+};
+
+/// Format of the vertex coordinates written by tessTesselateInto().
+///
+/// \par TESS_VERTEX_FLOAT32
+///
+///   TESSreal, as returned by tessGetVertices().
+///
+/// \par TESS_VERTEX_INT16
+///
+///   short, quantized over the bounds of the output vertices: each coordinate is mapped to
+///   -32767..32767 and restored as q * dequantScale[i] + dequantOffset[i].
+///
+/// \par TESS_VERTEX_FLOAT16
+///
+///   IEEE 754 half precision floats, stored as unsigned short.
+enum TessVertexFormat
+{
+    TESS_VERTEX_FLOAT32,
+    TESS_VERTEX_INT16,
+    TESS_VERTEX_FLOAT16,
+};
+    
+/// Per element values in tessGetElementMetric(), see tessSetElementMetrics().
+enum TessElementMetric
+{
+    TESS_METRIC_MIN_X,          // Bounding box of the element's vertices.
+    TESS_METRIC_MIN_Y,
+    TESS_METRIC_MIN_Z,
+    TESS_METRIC_MAX_X,
+    TESS_METRIC_MAX_Y,
+    TESS_METRIC_MAX_Z,
+    TESS_METRIC_CENTROID_X,     // Area centroid, or the average of the vertices if the area is 0.
+    TESS_METRIC_CENTROID_Y,
+    TESS_METRIC_CENTROID_Z,
+    TESS_METRIC_AREA,           // Unsigned area.
+    TESS_METRIC_COUNT,
 };
     
 typedef float TESSreal;
@@ -177,6 +338,108 @@ struct TESSalloc
     int extraVertices;			// Number of extra vertices allocated for the priority queue.
 };
 
+/// Callback used to create vertices at edge intersections, similar to GLU_TESS_COMBINE.
+/// Parameters:
+/// @param userData the pointer passed to tessSetCombineCallback().
+/// @param parents the 4 vertices the new vertex is interpolated from, identified like in tessGetVertexIndices().
+///     A parent which was itself created at an intersection has the index returned for it by the callback.
+/// @param weights the interpolation weights of the parents, they sum up to 1.
+/// @param coords the 'size' coordinates of the new vertex, linearly interpolated from the parents.
+///     The callback may overwrite them, e.g. to renormalize a vector.
+/// @param size the number of coordinates per vertex, the largest size passed to tessAddContour() but at least 3.
+/// @returns the index reported for the new vertex in tessGetVertexIndices(), for example the index of
+///     the attributes the callback has appended to a caller owned buffer, or TESS_UNDEF.
+typedef TESSindex (*TESScombineCallback)( void *_Nullable userData, const TESSindex *_Nonnull parents,
+										 const TESSreal *_Nonnull weights, TESSreal *_Nonnull coords, int size );
+
+/// Callback which receives the triangles of TESS_POLYGONS output, see tessSetTriangleCallback().
+/// Parameters:
+/// @param userData the pointer passed to tessSetTriangleCallback().
+/// @param vertices the coordinates of the 3 vertices, 'size' per vertex, in counter-clockwise order.
+/// @param vertexIndices the indices of the 3 vertices, as in tessGetVertexIndices().
+/// @param size the number of coordinates per vertex, as passed to tessTesselate().
+typedef void (*TESStriangleCallback)( void *_Nullable userData, const TESSreal *_Nonnull vertices,
+									  const TESSindex *_Nonnull vertexIndices, int size );
+
+/// Caller owned destination buffers for tessTesselateInto().
+/// Vertex i is written at vertices + i * vertexStride: its vertexSize coordinates at positionOffset,
+/// and its original index (see tessGetVertexIndices()) at vertexIndexOffset. The offsets and the stride
+/// need not be aligned, but the coordinates and the index must lie within vertexStride bytes without
+/// overlapping. Indices are laid out as by tessGetElements(), and elements must be aligned for indexType.
+typedef struct TESSoutputLayout
+{
+    void*_Nullable vertices;    // Vertex buffer, or NULL to write only the indices.
+    int vertexStride;           // Bytes between the starts of consecutive vertices.
+    int positionOffset;         // Byte offset of the coordinates within a vertex.
+    int vertexIndexOffset;      // Byte offset of the original vertex index within a vertex, or -1 to leave it out.
+    int vertexCapacity;         // Number of vertices that fit in 'vertices'.
+    void*_Nullable elements;    // Index buffer.
+    int indexType;              // One of TessIndexType.
+    int indexCapacity;          // Number of indices that fit in 'elements'.
+    int vertexFormat;           // One of TessVertexFormat, 0 is TESS_VERTEX_FLOAT32.
+
+    // Set by tessTesselateInto(), also when the buffers are too small.
+    int vertexCount;            // Number of vertices in the output.
+    int elementCount;           // Number of elements in the output, as tessGetElementCount().
+    int indexCount;             // Number of indices in the output.
+    TESSreal dequantScale[MAX_DIMENSIONS];     // Restores TESS_VERTEX_INT16 coordinates, 1 and 0 for
+    TESSreal dequantOffset[MAX_DIMENSIONS];    // the other formats.
+} TESSoutputLayout;
+
+/// A cluster of adjacent triangles in TESS_MESHLETS output.
+typedef struct TESSmeshlet
+{
+    int vertexOffset;           // First entry in tessGetMeshletVertices().
+    int vertexCount;            // Number of vertices used by the meshlet.
+    int triangleOffset;         // First triangle, in tessGetElements() and tessGetMeshletTriangles().
+    int triangleCount;          // Number of triangles in the meshlet.
+    TESSreal bmin[3];           // Bounding box of the meshlet's vertices.
+    TESSreal bmax[3];
+} TESSmeshlet;
+
+/// The part of the output added by one call to tessTesselate(), see tessSetAppendOutput().
+typedef struct TESSdrawRange
+{
+    int firstIndex;             // First entry of the call's elements in tessGetElements().
+    int indexCount;             // Number of entries added by the call.
+    int baseVertex;             // First vertex of the call in tessGetVertices().
+    int vertexCount;            // Number of vertices added by the call.
+} TESSdrawRange;
+
+/// Output of a tesselation which has been detached from its tesselator, see tessDetachResult().
+typedef struct TESSresult
+{
+    TESSreal*_Nullable vertices;            // As tessGetVertices().
+    TESSindex*_Nullable vertexIndices;      // As tessGetVertexIndices().
+    int vertexCount;
+    TESSindex*_Nullable elements;           // As tessGetElements().
+    int elementCount;
+    int indexCount;                         // As tessGetIndexCount().
+    TESSmeshlet*_Nullable meshlets;         // As tessGetMeshlets(), for TESS_MESHLETS output.
+    int meshletCount;
+    TESSindex*_Nullable meshletVertices;
+    unsigned char*_Nullable meshletTriangles;
+    TESSindex*_Nullable elementContours;    // As tessGetElementContours(), if provenance was enabled.
+    TESSindex*_Nullable edgeContours;       // As tessGetEdgeContours().
+    TESSreal*_Nullable metrics;             // TESS_METRIC_COUNT rows of metricsMax values, if element metrics
+                                            // were enabled. Row m is tessGetElementMetric() for metric m.
+    TESSdrawRange*_Nullable drawRanges;     // As tessGetDrawRanges().
+    int drawRangeCount;
+
+    // Allocated lengths of the buffers, and the allocator they are freed with.
+    int verticesMax;
+    int vertexIndicesMax;
+    int elementsMax;
+    int meshletsMax;
+    int meshletVerticesMax;
+    int meshletTrianglesMax;
+    int elementContoursMax;
+    int edgeContoursMax;
+    int metricsMax;
+    int drawRangesMax;
+    TESSalloc alloc;
+} TESSresult;
+
 /// tessNewTess() - Creates a new tesselator.
 /// Use tessDeleteTess() to delete the tesselator.
 /// Parameters:
@@ -193,6 +456,10 @@ void tessDeleteTess( TESStesselator *_Nonnull tess );
 
 /// tessAddContour() - Adds a contour to be tesselated.
 /// The type of the vertex coordinates is assumed to be TESSreal.
+/// A first contour which is convex, flat in z and of at most 32 vertices is kept out of the mesh: if it
+/// stays the only one and is tesselated into TESS_POLYGONS triangles, with none of provenance, element
+/// metrics, vertex cache optimization, Delaunay refinement, a triangle callback, an output layout or a
+/// normal, the triangles are written directly, skipping the sweep. The output is the same either way.
 /// Parameters:
 /// @param tess pointer to tesselator object.
 /// @param size number of coordinates per vertex. Must be 2 or 3.
@@ -220,6 +487,60 @@ void tessAddContour( TESStesselator *_Nonnull tess, int size, const void*_Nonnul
 SWIFT_COMPILE_NAME("Tesselator.tesselate(self:windingRule:elementType:polySize:vertexSize:normal:)")
 int tessTesselate( TESStesselator *_Nonnull tess, int windingRule, int elementType, int polySize, int vertexSize, const TESSreal*_Nullable normal );
 
+/// tessTesselateInto() - tesselate contours, writing the output directly to caller owned buffers.
+/// Parameters are as for tessTesselate(), plus:
+/// @param layout
+///     destination buffers and their layout. The sizes of the output are stored in it in every case.
+/// @returns 1 if the output was written to the buffers in layout, -1 if they are too small, 0 if failed.
+///     Fails while append mode is on, see tessSetAppendOutput(), leaving the appended output as it is,
+///     and, before tesselating, when the formats in layout are unknown or a vertex does not fit its stride.
+///     When the buffers are too small, the output is available through tessGetVertices() and
+///     tessGetElements() as after tessTesselate(), and layout holds the sizes needed next time.
+SWIFT_COMPILE_NAME("Tesselator.tesselate(self:windingRule:elementType:polySize:vertexSize:normal:layout:)")
+int tessTesselateInto( TESStesselator *_Nonnull tess, int windingRule, int elementType, int polySize, int vertexSize, const TESSreal*_Nullable normal, TESSoutputLayout *_Nonnull layout );
+
+/// tessRasterize() - renders the contours added since the last call to tessTesselate() into an
+/// 8-bit coverage mask, without tesselating them, and then discards them as tessTesselate() does.
+/// Each row of pixels is sampled by scanlines. The edges are sorted once by their upper end, and an
+/// active edge table is carried from one scanline to the next: edges are added and dropped as y
+/// passes their ends, and only those which cross each other between two scanlines change places.
+/// A scanline thus costs time in the number of edges crossing it, and beyond the table of the
+/// edges, memory use depends on that number too.
+/// Contours are projected onto the xy plane.
+/// Parameters:
+/// @param tess
+///     pointer to tesselator object.
+/// @param windingRule
+///     winding rules used to decide what is inside, must be one of TessWindingRule. As with
+///     tessTesselate() without a normal, winding numbers count so that the contours have a
+///     non-negative total area.
+/// @param mask
+///     height rows of width pixels. The coverage of each pixel, 0 to 255, is added to it,
+///     saturating, so several calls may accumulate into one mask.
+/// @param width
+///     width of the mask in pixels.
+/// @param height
+///     height of the mask in pixels.
+/// @param stride
+///     distance in bytes between the starts of rows of the mask.
+/// @param viewBox
+///     minimum x, minimum y, maximum x and maximum y of the area mapped onto the mask, with
+///     row 0 at minimum y; if null, the bounds of the contours.
+/// @param samples
+///     number of scanlines per row of pixels, at least 1. Coverage along the scanlines is exact.
+/// @returns 1 if succeed, 0 if failed.
+SWIFT_COMPILE_NAME("Tesselator.rasterize(self:windingRule:mask:width:height:stride:viewBox:samples:)")
+int tessRasterize( TESStesselator *_Nonnull tess, int windingRule, unsigned char *_Nonnull mask, int width, int height, int stride, const TESSreal*_Nullable viewBox, int samples );
+
+/// tessReset() - Discards the contours added since the last call to tessTesselate().
+/// tessTesselate() does this itself when it finishes. The mesh, sweep structures and
+/// output buffers keep their capacity, so once a tesselator has handled input of a given
+/// size, tesselating similar input again makes no further calls to the allocator.
+/// Parameters:
+/// @param tess pointer to tesselator object.
+SWIFT_COMPILE_NAME("Tesselator.reset(self:)")
+void tessReset( TESStesselator *_Nonnull tess );
+
 /// tessGetVertexCount() - Returns number of vertices in the tesselated output.
 int tessGetVertexCount( TESStesselator *_Nonnull tess );
 
@@ -235,15 +556,193 @@ const TESSindex*_Nonnull tessGetVertexIndices( TESStesselator *_Nonnull tess );
 /// tessGetElementCount() - Returns number of elements in the the tesselated output.
 int tessGetElementCount( TESStesselator *_Nonnull tess );
 
+/// tessGetIndexCount() - Returns number of entries in the element array, including the
+/// TESS_UNDEF terminators of strips and fans.
+int tessGetIndexCount( TESStesselator *_Nonnull tess );
+
 /// tessGetElements() - Returns pointer to the first element.
 const TESSindex*_Nonnull tessGetElements( TESStesselator *_Nonnull tess );
 
+/// tessGetMeshletCount() - Returns number of meshlets in TESS_MESHLETS output.
+int tessGetMeshletCount( TESStesselator *_Nonnull tess );
+
+/// tessGetMeshlets() - Returns pointer to the first meshlet.
+const TESSmeshlet*_Nonnull tessGetMeshlets( TESStesselator *_Nonnull tess );
+
+/// tessGetMeshletVertices() - Returns pointer to the vertex lists of the meshlets. Each meshlet's
+/// vertices are listed at its vertexOffset, as indices to tessGetVertices().
+const TESSindex*_Nonnull tessGetMeshletVertices( TESStesselator *_Nonnull tess );
+
+/// tessGetMeshletTriangles() - Returns pointer to the local index buffers of the meshlets, 3 entries
+/// per triangle starting at triangleOffset * 3, each an index to the meshlet's vertex list.
+const unsigned char*_Nonnull tessGetMeshletTriangles( TESStesselator *_Nonnull tess );
+
+/// tessGetProvenance() - Returns whether the contours the output comes from are reported.
+bool tessGetProvenance( TESStesselator *_Nonnull tess );
+
+/// tessSetProvenance() - Sets whether tessTesselate() reports which contour each part of the output comes
+/// from, in tessGetElementContours() and tessGetEdgeContours(). Contours are numbered by their
+/// tessAddContour() call, starting at 0 after each tessTesselate(). Supported for TESS_POLYGONS,
+/// TESS_CONNECTED_POLYGONS and TESS_BOUNDARY_CONTOURS; the arrays are not filled for the other element types.
+/// Default is FALSE.
+void tessSetProvenance( TESStesselator *_Nonnull tess, bool value );
+
+/// tessGetElementContours() - Returns the contour each element comes from: that of the nearest input
+/// edge above it in the sweep direction, or TESS_UNDEF. Below a hole this is the hole's contour, so the
+/// contours which make up one shape should be mapped to that shape. For TESS_BOUNDARY_CONTOURS the
+/// element is the region the output contour bounds.
+const TESSindex*_Nonnull tessGetElementContours( TESStesselator *_Nonnull tess );
+
+/// tessGetEdgeContours() - Returns the contour of the input edge each output edge lies on, or TESS_UNDEF
+/// for edges added by the tesselation, such as the diagonals of triangles. Input edges split at
+/// intersections keep their contour. For polygons there are polySize entries per element, entry j for
+/// the edge from vertex j to vertex j + 1 (TESS_UNDEF in unused slots); for TESS_BOUNDARY_CONTOURS one
+/// entry per vertex, for the edge starting at it.
+const TESSindex*_Nonnull tessGetEdgeContours( TESStesselator *_Nonnull tess );
+
+/// tessGetElementMetrics() - Returns whether per element metrics are computed.
+bool tessGetElementMetrics( TESStesselator *_Nonnull tess );
+
+/// tessSetElementMetrics() - Sets whether tessTesselate() computes the bounding box, centroid and area of
+/// each element, in input coordinates (z is 0 for 2D input), while writing the output. Supported for
+/// TESS_POLYGONS, TESS_CONNECTED_POLYGONS and TESS_BOUNDARY_CONTOURS, and follows append mode.
+/// Default is FALSE.
+void tessSetElementMetrics( TESStesselator *_Nonnull tess, bool value );
+
+/// tessGetElementMetric() - Returns pointer to the values of one metric for all elements, one TESSreal
+/// per element. The metrics are stored as separate arrays, each 16 byte aligned when the allocator
+/// aligns to 16 bytes, so that they can be processed several elements at a time.
+/// Parameters:
+/// @param tess pointer to tesselator object.
+/// @param metric one of TessElementMetric.
+const TESSreal*_Nonnull tessGetElementMetric( TESStesselator *_Nonnull tess, int metric );
+
+/// tessGetAppendOutput() - Returns whether tessTesselate() appends to the output of the previous calls.
+bool tessGetAppendOutput( TESStesselator *_Nonnull tess );
+
+/// tessSetAppendOutput() - Sets whether tessTesselate() appends its output to that of the previous calls,
+/// so that many shapes accumulate in one vertex and element array. Element indices refer to the shared
+/// vertex array, and each call's part of the output is recorded as a TESSdrawRange. Supported for
+/// TESS_POLYGONS, TESS_TRIANGLE_STRIPS and TESS_TRIANGLE_FANS; the other element types fail, as does
+/// tessTesselateInto(). All calls should use the same vertexSize. Changing the setting
+/// clears the output. Default is FALSE.
+void tessSetAppendOutput( TESStesselator *_Nonnull tess, bool value );
+
+/// tessClearOutput() - Empties the output, and its draw ranges, keeping the capacity of the buffers.
+void tessClearOutput( TESStesselator *_Nonnull tess );
+
+/// tessGetDrawRangeCount() - Returns the number of draw ranges, one per call to tessTesselate() since
+/// the output was last cleared. Without append mode this is 1 after a successful call.
+int tessGetDrawRangeCount( TESStesselator *_Nonnull tess );
+
+/// tessGetDrawRanges() - Returns pointer to the first draw range.
+const TESSdrawRange*_Nonnull tessGetDrawRanges( TESStesselator *_Nonnull tess );
+
+/// tessDetachResult() - Transfers the output of the last tessTesselate() to a new result object,
+/// without copying, along with the element contours, element metrics and draw ranges. The tesselator no
+/// longer refers to the output, and clears it, so the result stays valid through later calls to
+/// tessTesselate(), which allocate new buffers, and tessDeleteTess().
+/// This lets one thread tesselate the next input while another consumes the result.
+/// Parameters:
+/// @param tess pointer to tesselator object.
+/// @returns the result, to be released with tessFreeResult() or tessRecycleResult(), or NULL if out of memory.
+TESSresult*_Nullable tessDetachResult( TESStesselator *_Nonnull tess );
+
+/// tessFreeResult() - Frees a result and its buffers, using the allocator of the tesselator it came
+/// from. May be called from any thread if that allocator is thread safe, as the default one is.
+/// Parameters:
+/// @param result the result returned by tessDetachResult().
+void tessFreeResult( TESSresult *_Nonnull result );
+
+/// tessRecycleResult() - Frees a result, handing its buffers back to the tesselator so that later
+/// calls to tessTesselate() can reuse them instead of allocating. Buffers the tesselator already has,
+/// e.g. because a newer result has not been detached yet, are kept and the recycled ones freed.
+/// Must not be called while the tesselator is in use by another thread.
+/// Parameters:
+/// @param tess the tesselator the result was detached from, or one using the same allocator.
+/// @param result the result returned by tessDetachResult().
+void tessRecycleResult( TESStesselator *_Nonnull tess, TESSresult *_Nonnull result );
+
 /// tessGetNoEmptyPolygons() - Returns whether a tesselator is set to not output empty polygons in the output.
 bool tessGetNoEmptyPolygons( TESStesselator *_Nonnull tess );
 
 /// tessSetNoEmptyPoltgons() - Sets whether a tesselator should disallow empty polygons in the output.
 /// Default is FALSE.
 void tessSetNoEmptyPolygons( TESStesselator *_Nonnull tess, bool value );
+
+/// tessSetCombineCallback() - Sets the callback which is called for every vertex created at an
+/// intersection of two edges. Without a callback such vertices have the index TESS_UNDEF.
+/// Parameters:
+/// @param tess pointer to tesselator object.
+/// @param callback the callback, or NULL to remove it.
+/// @param userData pointer passed back to the callback.
+void tessSetCombineCallback( TESStesselator *_Nonnull tess, TESScombineCallback _Nullable callback, void *_Nullable userData );
+
+/// tessSetTriangleCallback() - Sets a callback which receives TESS_POLYGONS output instead of the output
+/// arrays. Each monotone region is passed to the callback as triangles as soon as it has been
+/// triangulated, and then freed; polySize is ignored and the output arrays are left empty. The regions
+/// are only triangulated once the sweep has finished, so the swept mesh is still held in memory as a
+/// whole: this saves the output arrays and the diagonals of the triangulation, not the mesh itself.
+/// Parameters:
+/// @param tess pointer to tesselator object.
+/// @param callback the callback, or NULL to store the output as usual.
+/// @param userData pointer passed back to the callback.
+void tessSetTriangleCallback( TESStesselator *_Nonnull tess, TESStriangleCallback _Nullable callback, void *_Nullable userData );
+
+/// tessGetDictType() - Returns the edge dictionary type used by the tesselator, one of TessDictType.
+int tessGetDictType( TESStesselator *_Nonnull tess );
+
+/// tessSetDictType() - Sets the edge dictionary type used by subsequent calls to tessTesselate().
+/// Must be one of TessDictType. Default is TESS_DICT_SKIPLIST.
+void tessSetDictType( TESStesselator *_Nonnull tess, int type );
+
+/// tessGetOptimizeVertexCache() - Returns whether polygon output is reordered for the vertex cache.
+bool tessGetOptimizeVertexCache( TESStesselator *_Nonnull tess );
+
+/// tessSetOptimizeVertexCache() - Sets whether TESS_POLYGONS and TESS_CONNECTED_POLYGONS output is
+/// reordered for the GPU's post-transform vertex cache. The polygons are ordered so that vertices are
+/// reused soon after each other, and the vertices are numbered in the order they are first used.
+/// Default is false, the order then follows the internal mesh.
+void tessSetOptimizeVertexCache( TESStesselator *_Nonnull tess, bool value );
+
+/// tessGetDelaunay() - Returns whether triangulations are refined to be constrained Delaunay.
+bool tessGetDelaunay( TESStesselator *_Nonnull tess );
+
+/// tessSetDelaunay() - Sets whether the triangulation of the polygon interior is refined by edge flips
+/// until it is constrained Delaunay: of all triangulations which keep the edges of the contours and
+/// their intersections, the one that maximizes the smallest angle, avoiding slivers. Applies to every
+/// element type built from the triangulation, including TESS_POLYGONS with polySize > 3, whose
+/// polygons are merged from the refined triangles; not to output passed to a triangle callback.
+/// Default is false.
+void tessSetDelaunay( TESStesselator *_Nonnull tess, bool value );
+
+/// tessGetSimpleContours() - Returns whether the contours are declared simple.
+bool tessGetSimpleContours( TESStesselator *_Nonnull tess );
+
+/// tessSetSimpleContours() - Declares that the edges of the contours do not cross, overlap or touch each
+/// other, except at shared vertices; in particular no vertex lies on another edge. The sweep then only splits
+/// the polygon into monotone regions, skipping the intersection and splice checks, and reserves no
+/// room for intersection vertices.
+/// In builds without NDEBUG, the sweep checks the declaration where it would have repaired the edges:
+/// contours found not to be simple make tessTesselate() fail, with tessGetSimpleViolation() set, and are
+/// discarded. With NDEBUG the check is compiled out, and the output for such contours is undefined.
+/// Default is false.
+void tessSetSimpleContours( TESStesselator *_Nonnull tess, bool value );
+
+/// tessGetSimpleViolation() - Returns whether the last call to tessTesselate() failed because contours
+/// declared simple with tessSetSimpleContours() were not.
+bool tessGetSimpleViolation( TESStesselator *_Nonnull tess );
+
+/// tessGetMeshletMaxVertices() - Returns the maximum number of vertices per meshlet.
+int tessGetMeshletMaxVertices( TESStesselator *_Nonnull tess );
+
+/// tessGetMeshletMaxTriangles() - Returns the maximum number of triangles per meshlet.
+int tessGetMeshletMaxTriangles( TESStesselator *_Nonnull tess );
+
+/// tessSetMeshletLimits() - Sets the size limits of the meshlets in TESS_MESHLETS output.
+/// maxVertices is clamped to 3..256 so that local indices fit in a byte, maxTriangles to 1..512.
+/// Default is 64 vertices and 126 triangles.
+void tessSetMeshletLimits( TESStesselator *_Nonnull tess, int maxVertices, int maxTriangles );
     
 #ifdef __cplusplus
 };
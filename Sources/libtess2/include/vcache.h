@@ -0,0 +1,59 @@
+/*
+** SGI FREE SOFTWARE LICENSE B (Version 2.0, Sept. 18, 2008) 
+** Copyright (C) [dates of first publication] Silicon Graphics, Inc.
+** All Rights Reserved.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+** of the Software, and to permit persons to whom the Software is furnished to do so,
+** subject to the following conditions:
+** 
+** The above copyright notice including the dates of first publication and either this
+** permission notice or a reference to http://oss.sgi.com/projects/FreeB/ shall be
+** included in all copies or substantial portions of the Software. 
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+** INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+** PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL SILICON GRAPHICS, INC.
+** BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+** TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+** OR OTHER DEALINGS IN THE SOFTWARE.
+** 
+** Except as contained in this notice, the name of Silicon Graphics, Inc. shall not
+** be used in advertising or otherwise to promote the sale, use or other dealings in
+** this Software without prior written authorization from Silicon Graphics, Inc.
+*/
+
+#ifndef VCACHE_H
+#define VCACHE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "tesselator.h"
+
+/* Size of the simulated LRU post-transform cache. */
+#define VCACHE_SIZE 32
+
+/* vcacheScratchSize( faceCount, polySize, vertexCount ) returns the number
+* of bytes of scratch memory vcacheOrderFaces() needs.
+*
+* vcacheOrderFaces( faces, faceCount, polySize, vertexCount, scratch, order )
+* orders the faces so that vertices are reused while they are still in
+* the GPU's post-transform cache (Forsyth, "Linear-Speed Vertex Cache
+* Optimisation").  "faces" holds polySize vertex indices per face, padded
+* with TESS_UNDEF; the faces should be output in the order stored to
+* order[0..faceCount-1].
+*/
+size_t vcacheScratchSize( int faceCount, int polySize, int vertexCount );
+void vcacheOrderFaces( const TESSindex *faces, int faceCount, int polySize, int vertexCount,
+					   void *scratch, int *order );
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif
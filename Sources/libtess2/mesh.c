@@ -57,6 +57,7 @@ static TESShalfEdge *MakeEdge( TESSmesh* mesh, TESShalfEdge *eNext )
 	TESShalfEdge *ePrev;
 	EdgePair *pair = (EdgePair *)bucketAlloc( mesh->edgeBucket );
 	if (pair == NULL) return NULL;
+	mesh->edgeCount++;
 
 	e = &pair->e;
 	eSym = &pair->eSym;
@@ -79,6 +80,7 @@ static TESShalfEdge *MakeEdge( TESSmesh* mesh, TESShalfEdge *eNext )
 	e->Org = NULL;
 	e->Lface = NULL;
 	e->winding = 0;
+	e->contour = TESS_UNDEF;
 	e->activeRegion = NULL;
 
 	eSym->Sym = e;
@@ -87,6 +89,7 @@ static TESShalfEdge *MakeEdge( TESSmesh* mesh, TESShalfEdge *eNext )
 	eSym->Org = NULL;
 	eSym->Lface = NULL;
 	eSym->winding = 0;
+	eSym->contour = TESS_UNDEF;
 	eSym->activeRegion = NULL;
 
 	return e;
@@ -109,13 +112,13 @@ static void Splice( TESShalfEdge *a, TESShalfEdge *b )
 	b->Onext = aOnext;
 }
 
-/* MakeVertex( newVertex, eOrig, vNext ) attaches a new vertex and makes it the
+/* MakeVertex( mesh, newVertex, eOrig, vNext ) attaches a new vertex and makes it the
 * origin of all edges in the vertex loop to which eOrig belongs. "vNext" gives
 * a place to insert the new vertex in the global vertex list.  We insert
 * the new vertex *before* vNext so that algorithms which walk the vertex
 * list will not see the newly created vertices.
 */
-static void MakeVertex( TESSvertex *newVertex, 
+static void MakeVertex( TESSmesh *mesh, TESSvertex *newVertex, 
 					   TESShalfEdge *eOrig, TESSvertex *vNext )
 {
 	TESShalfEdge *e;
@@ -123,6 +126,7 @@ static void MakeVertex( TESSvertex *newVertex,
 	TESSvertex *vNew = newVertex;
 
 	assert(vNew != NULL);
+	mesh->vertexCount++;
 
 	/* insert in circular doubly-linked list before vNext */
 	vPrev = vNext->prev;
@@ -132,7 +136,8 @@ static void MakeVertex( TESSvertex *newVertex,
 	vNext->prev = vNew;
 
 	vNew->anEdge = eOrig;
-	/* leave coords, s, t undefined */
+	vNew->data = TESS_UNDEF;
+	/* leave s, t undefined */
 
 	/* fix other edges on this vertex loop */
 	e = eOrig;
@@ -142,19 +147,20 @@ static void MakeVertex( TESSvertex *newVertex,
 	} while( e != eOrig );
 }
 
-/* MakeFace( newFace, eOrig, fNext ) attaches a new face and makes it the left
+/* MakeFace( mesh, newFace, eOrig, fNext ) attaches a new face and makes it the left
 * face of all edges in the face loop to which eOrig belongs.  "fNext" gives
 * a place to insert the new face in the global face list.  We insert
 * the new face *before* fNext so that algorithms which walk the face
 * list will not see the newly created faces.
 */
-static void MakeFace( TESSface *newFace, TESShalfEdge *eOrig, TESSface *fNext )
+static void MakeFace( TESSmesh *mesh, TESSface *newFace, TESShalfEdge *eOrig, TESSface *fNext )
 {
 	TESShalfEdge *e;
 	TESSface *fPrev;
 	TESSface *fNew = newFace;
 
 	assert(fNew != NULL); 
+	mesh->faceCount++;
 
 	/* insert in circular doubly-linked list before fNext */
 	fPrev = fNext->prev;
@@ -171,6 +177,7 @@ static void MakeFace( TESSface *newFace, TESShalfEdge *eOrig, TESSface *fNext )
 	* convenience for the common case where a face has been split in two.
 	*/
 	fNew->inside = fNext->inside;
+	fNew->contour = fNext->contour;
 
 	/* fix other edges on this face loop */
 	e = eOrig;
@@ -197,6 +204,7 @@ static void KillEdge( TESSmesh *mesh, TESShalfEdge *eDel )
 	ePrev->Sym->next = eNext;
 
 	bucketFree( mesh->edgeBucket, eDel );
+	mesh->edgeCount--;
 }
 
 
@@ -222,6 +230,7 @@ static void KillVertex( TESSmesh *mesh, TESSvertex *vDel, TESSvertex *newOrg )
 	vPrev->next = vNext;
 
 	bucketFree( mesh->vertexBucket, vDel );
+	mesh->vertexCount--;
 }
 
 /* KillFace( fDel ) destroys a face and removes it from the global face
@@ -246,6 +255,7 @@ static void KillFace( TESSmesh *mesh, TESSface *fDel, TESSface *newLface )
 	fPrev->next = fNext;
 
 	bucketFree( mesh->faceBucket, fDel );
+	mesh->faceCount--;
 }
 
 
@@ -272,9 +282,9 @@ TESShalfEdge *tessMeshMakeEdge( TESSmesh *mesh )
 	e = MakeEdge( mesh, &mesh->eHead );
 	if (e == NULL) return NULL;
 
-	MakeVertex( newVertex1, e, &mesh->vHead );
-	MakeVertex( newVertex2, e->Sym, &mesh->vHead );
-	MakeFace( newFace, e, &mesh->fHead );
+	MakeVertex( mesh, newVertex1, e, &mesh->vHead );
+	MakeVertex( mesh, newVertex2, e->Sym, &mesh->vHead );
+	MakeFace( mesh, newFace, e, &mesh->fHead );
 	return e;
 }
 
@@ -330,7 +340,7 @@ int tessMeshSplice( TESSmesh* mesh, TESShalfEdge *eOrg, TESShalfEdge *eDst )
 		/* We split one vertex into two -- the new vertex is eDst->Org.
 		* Make sure the old vertex points to a valid half-edge.
 		*/
-		MakeVertex( newVertex, eDst, eOrg->Org );
+		MakeVertex( mesh, newVertex, eDst, eOrg->Org );
 		eOrg->Org->anEdge = eOrg;
 	}
 	if( ! joiningLoops ) {
@@ -340,7 +350,7 @@ int tessMeshSplice( TESSmesh* mesh, TESShalfEdge *eOrg, TESShalfEdge *eDst )
 		/* We split one loop into two -- the new loop is eDst->Lface.
 		* Make sure the old face points to a valid half-edge.
 		*/
-		MakeFace( newFace, eDst, eOrg->Lface );
+		MakeFace( mesh, newFace, eDst, eOrg->Lface );
 		eOrg->Lface->anEdge = eOrg;
 	}
 
@@ -385,7 +395,7 @@ int tessMeshDelete( TESSmesh *mesh, TESShalfEdge *eDel )
 			if (newFace == NULL) return 0; 
 
 			/* We are splitting one loop into two -- create a new loop for eDel. */
-			MakeFace( newFace, eDel, eDel->Lface );
+			MakeFace( mesh, newFace, eDel, eDel->Lface );
 		}
 	}
 
@@ -437,7 +447,7 @@ TESShalfEdge *tessMeshAddEdgeVertex( TESSmesh *mesh, TESShalfEdge *eOrg )
 		TESSvertex *newVertex= (TESSvertex*)bucketAlloc( mesh->vertexBucket );
 		if (newVertex == NULL) return NULL;
 
-		MakeVertex( newVertex, eNewSym, eNew->Org );
+		MakeVertex( mesh, newVertex, eNewSym, eNew->Org );
 	}
 	eNew->Lface = eNewSym->Lface = eOrg->Lface;
 
@@ -467,6 +477,8 @@ TESShalfEdge *tessMeshSplitEdge( TESSmesh *mesh, TESShalfEdge *eOrg )
 	eNew->Rface = eOrg->Rface;
 	eNew->winding = eOrg->winding;	/* copy old winding information */
 	eNew->Sym->winding = eOrg->Sym->winding;
+	eNew->contour = eOrg->contour;
+	eNew->Sym->contour = eOrg->Sym->contour;
 
 	return eNew;
 }
@@ -514,12 +526,56 @@ TESShalfEdge *tessMeshConnect( TESSmesh *mesh, TESShalfEdge *eOrg, TESShalfEdge
 		if (newFace == NULL) return NULL;
 
 		/* We split one loop into two -- the new loop is eNew->Lface */
-		MakeFace( newFace, eNew, eOrg->Lface );
+		MakeFace( mesh, newFace, eNew, eOrg->Lface );
 	}
 	return eNew;
 }
 
 
+/* tessMeshFlipEdge( eFlip ) replaces eFlip, the diagonal of the
+* quadrilateral formed by its left and right faces (both triangles),
+* by the other diagonal.  The same half-edges and faces are reused, so
+* pointers to them stay valid; eFlip keeps its left face, and becomes
+* the edge from the apex of its old right face to the apex of its old
+* left face.
+*/
+void tessMeshFlipEdge( TESShalfEdge *eFlip )
+{
+	TESShalfEdge *a0 = eFlip, *a1 = a0->Lnext, *a2 = a1->Lnext;
+	TESShalfEdge *b0 = eFlip->Sym, *b1 = b0->Lnext, *b2 = b1->Lnext;
+	TESSvertex *aOrg = a0->Org, *bOrg = b0->Org;
+	TESSface *fa = a0->Lface, *fb = b0->Lface;
+
+	assert( a2->Lnext == a0 && b2->Lnext == b0 && fa != fb );
+
+	a0->Org = b2->Org;
+	b0->Org = a2->Org;
+
+	/* Each half-edge x with x->Lnext == y is y->Onext->Sym. */
+	a0->Lnext = a2;
+	a2->Lnext = b1;
+	b1->Lnext = a0;
+	b0->Lnext = b2;
+	b2->Lnext = a1;
+	a1->Lnext = b0;
+
+	a0->Onext = b1->Sym;
+	a1->Onext = b2->Sym;
+	a2->Onext = b0;
+	b0->Onext = a1->Sym;
+	b1->Onext = a2->Sym;
+	b2->Onext = a0;
+
+	a1->Lface = fb;
+	b1->Lface = fa;
+	fa->anEdge = a0;
+	fb->anEdge = b0;
+
+	if( aOrg->anEdge == a0 ) aOrg->anEdge = b1;
+	if( bOrg->anEdge == b0 ) bOrg->anEdge = a1;
+}
+
+
 /******************** Other Operations **********************/
 
 /* tessMeshZapFace( fZap ) destroys a face and removes it from the
@@ -571,41 +627,16 @@ void tessMeshZapFace( TESSmesh *mesh, TESSface *fZap )
 	fPrev->next = fNext;
 
 	bucketFree( mesh->faceBucket, fZap );
+	mesh->faceCount--;
 }
 
 
-/* tessMeshNewMesh() creates a new mesh with no edges, no vertices,
-* and no loops (what we usually call a "face").
-*/
-TESSmesh *tessMeshNewMesh( TESSalloc* alloc )
+static void InitHeads( TESSmesh *mesh )
 {
 	TESSvertex *v;
 	TESSface *f;
 	TESShalfEdge *e;
 	TESShalfEdge *eSym;
-	TESSmesh *mesh = (TESSmesh *)alloc->memalloc( alloc->userData, sizeof( TESSmesh ));
-	if (mesh == NULL) {
-		return NULL;
-	}
-	
-	if (alloc->meshEdgeBucketSize < 16)
-		alloc->meshEdgeBucketSize = 16;
-	if (alloc->meshEdgeBucketSize > 4096)
-		alloc->meshEdgeBucketSize = 4096;
-	
-	if (alloc->meshVertexBucketSize < 16)
-		alloc->meshVertexBucketSize = 16;
-	if (alloc->meshVertexBucketSize > 4096)
-		alloc->meshVertexBucketSize = 4096;
-	
-	if (alloc->meshFaceBucketSize < 16)
-		alloc->meshFaceBucketSize = 16;
-	if (alloc->meshFaceBucketSize > 4096)
-		alloc->meshFaceBucketSize = 4096;
-
-	mesh->edgeBucket = createBucketAlloc( alloc, "Mesh Edges", sizeof(EdgePair), alloc->meshEdgeBucketSize );
-	mesh->vertexBucket = createBucketAlloc( alloc, "Mesh Vertices", sizeof(TESSvertex), alloc->meshVertexBucketSize );
-	mesh->faceBucket = createBucketAlloc( alloc, "Mesh Faces", sizeof(TESSface), alloc->meshFaceBucketSize );
 
 	v = &mesh->vHead;
 	f = &mesh->fHead;
@@ -620,6 +651,7 @@ TESSmesh *tessMeshNewMesh( TESSalloc* alloc )
 	f->trail = NULL;
 	f->marked = FALSE;
 	f->inside = FALSE;
+	f->contour = TESS_UNDEF;
 
 	e->next = e;
 	e->Sym = eSym;
@@ -628,6 +660,7 @@ TESSmesh *tessMeshNewMesh( TESSalloc* alloc )
 	e->Org = NULL;
 	e->Lface = NULL;
 	e->winding = 0;
+	e->contour = TESS_UNDEF;
 	e->activeRegion = NULL;
 
 	eSym->next = eSym;
@@ -637,8 +670,45 @@ TESSmesh *tessMeshNewMesh( TESSalloc* alloc )
 	eSym->Org = NULL;
 	eSym->Lface = NULL;
 	eSym->winding = 0;
+	eSym->contour = TESS_UNDEF;
 	eSym->activeRegion = NULL;
 
+	mesh->vertexCount = 0;
+	mesh->faceCount = 0;
+	mesh->edgeCount = 0;
+}
+
+/* tessMeshNewMesh() creates a new mesh with no edges, no vertices,
+* and no loops (what we usually call a "face").
+*/
+TESSmesh *tessMeshNewMesh( TESSalloc* alloc )
+{
+	TESSmesh *mesh = (TESSmesh *)alloc->memalloc( alloc->userData, sizeof( TESSmesh ));
+	if (mesh == NULL) {
+		return NULL;
+	}
+	
+	if (alloc->meshEdgeBucketSize < 16)
+		alloc->meshEdgeBucketSize = 16;
+	if (alloc->meshEdgeBucketSize > 4096)
+		alloc->meshEdgeBucketSize = 4096;
+	
+	if (alloc->meshVertexBucketSize < 16)
+		alloc->meshVertexBucketSize = 16;
+	if (alloc->meshVertexBucketSize > 4096)
+		alloc->meshVertexBucketSize = 4096;
+	
+	if (alloc->meshFaceBucketSize < 16)
+		alloc->meshFaceBucketSize = 16;
+	if (alloc->meshFaceBucketSize > 4096)
+		alloc->meshFaceBucketSize = 4096;
+
+	mesh->edgeBucket = createBucketAlloc( alloc, "Mesh Edges", sizeof(EdgePair), alloc->meshEdgeBucketSize );
+	mesh->vertexBucket = createBucketAlloc( alloc, "Mesh Vertices", sizeof(TESSvertex), alloc->meshVertexBucketSize );
+	mesh->faceBucket = createBucketAlloc( alloc, "Mesh Faces", sizeof(TESSface), alloc->meshFaceBucketSize );
+
+	InitHeads( mesh );
+
 	return mesh;
 }
 
@@ -677,24 +747,15 @@ TESSmesh *tessMeshUnion( TESSalloc* alloc, TESSmesh *mesh1, TESSmesh *mesh2 )
 		e1->Sym->next = e2->Sym->next;
 	}
 
+	mesh1->vertexCount += mesh2->vertexCount;
+	mesh1->faceCount += mesh2->faceCount;
+	mesh1->edgeCount += mesh2->edgeCount;
+
 	alloc->memfree( alloc->userData, mesh2 );
 	return mesh1;
 }
 
 
-static int CountFaceVerts( TESSface *f )
-{
-	TESShalfEdge *eCur = f->anEdge;
-	int n = 0;
-	do
-	{
-		n++;
-		eCur = eCur->Lnext;
-	}
-	while (eCur != f->anEdge);
-	return n;
-}
-
 TESSreal tessFaceArea( TESSface *face )
 {
     TESSreal area = 0.0f;
@@ -707,12 +768,23 @@ TESSreal tessFaceArea( TESSface *face )
     return area;
 }
 
+/* tessMeshMergeConvexFaces() grows each inside face by removing edges for
+* as long as the result stays convex and within maxVertsPerFace vertices.
+* The vertex counts of the inside faces are cached in f->n.
+*/
 int tessMeshMergeConvexFaces( TESSmesh *mesh, int maxVertsPerFace )
 {
 	TESSface *f;
 	TESShalfEdge *eCur, *eNext, *eSym;
 	TESSvertex *vStart;
 	int curNv, symNv;
+
+	// The inside faces start out as triangles.
+	for( f = mesh->fHead.next; f != &mesh->fHead; f = f->next )
+	{
+		if( f->inside )
+			f->n = 3;
+	}
 	
 	for( f = mesh->fHead.next; f != &mesh->fHead; f = f->next )
 	{
@@ -733,8 +805,8 @@ int tessMeshMergeConvexFaces( TESSmesh *mesh, int maxVertsPerFace )
 			{
 				// Try to merge the neighbour faces if the resulting polygons
 				// does not exceed maximum number of vertices.
-				curNv = CountFaceVerts( f );
-				symNv = CountFaceVerts( eSym->Lface );
+				curNv = f->n;
+				symNv = eSym->Lface->n;
 				if( (curNv+symNv-2) <= maxVertsPerFace )
 				{
 					// Merge if the resulting poly is convex.
@@ -744,6 +816,7 @@ int tessMeshMergeConvexFaces( TESSmesh *mesh, int maxVertsPerFace )
 						eNext = eSym->Lnext;
 						if( !tessMeshDelete( mesh, eSym ) )
 							return 0;
+						f->n = curNv + symNv - 2;
 						eCur = 0;
 					}
 				}
@@ -792,6 +865,18 @@ void tessMeshDeleteMesh( TESSalloc* alloc, TESSmesh *mesh )
 
 #endif
 
+/* tessMeshResetMesh( mesh ) empties the mesh but keeps the buckets, so
+* the mesh can be filled again without calling the allocator.
+*/
+void tessMeshResetMesh( TESSmesh *mesh )
+{
+	bucketReset(mesh->edgeBucket);
+	bucketReset(mesh->vertexBucket);
+	bucketReset(mesh->faceBucket);
+
+	InitHeads( mesh );
+}
+
 #ifndef NDEBUG
 
 /* tessMeshCheckMesh( mesh ) checks a mesh for self-consistency.
@@ -804,9 +889,11 @@ void tessMeshCheckMesh( TESSmesh *mesh )
 	TESSface *f, *fPrev;
 	TESSvertex *v, *vPrev;
 	TESShalfEdge *e, *ePrev;
+	int nf = 0, nv = 0, ne = 0;
 
 	for( fPrev = fHead ; (f = fPrev->next) != fHead; fPrev = f) {
 		assert( f->prev == fPrev );
+		nf++;
 		e = f->anEdge;
 		do {
 			assert( e->Sym != e );
@@ -818,9 +905,11 @@ void tessMeshCheckMesh( TESSmesh *mesh )
 		} while( e != f->anEdge );
 	}
 	assert( f->prev == fPrev && f->anEdge == NULL );
+	assert( nf == mesh->faceCount );
 
 	for( vPrev = vHead ; (v = vPrev->next) != vHead; vPrev = v) {
 		assert( v->prev == vPrev );
+		nv++;
 		e = v->anEdge;
 		do {
 			assert( e->Sym != e );
@@ -832,9 +921,11 @@ void tessMeshCheckMesh( TESSmesh *mesh )
 		} while( e != v->anEdge );
 	}
 	assert( v->prev == vPrev && v->anEdge == NULL );
+	assert( nv == mesh->vertexCount );
 
 	for( ePrev = eHead ; (e = ePrev->next) != eHead; ePrev = e) {
 		assert( e->Sym->next == ePrev->Sym );
+		ne++;
 		assert( e->Sym != e );
 		assert( e->Sym->Sym == e );
 		assert( e->Org != NULL );
@@ -847,6 +938,7 @@ void tessMeshCheckMesh( TESSmesh *mesh )
 		&& e->Sym->Sym == e
 		&& e->Org == NULL && e->Dst == NULL
 		&& e->Lface == NULL && e->Rface == NULL );
+	assert( ne == mesh->edgeCount );
 }
 
 #endif
@@ -41,11 +41,13 @@
 #define TRUE 1
 #define FALSE 0
 
+/* The heap keeps copies of the vertex coordinates, see below. */
+#include "geom.h"
+
 #ifdef FOR_TRITE_TEST_PROGRAM
 #define LEQ(x,y)	(*pq->leq)(x,y)
 #else
 /* Violates modularity, but a little faster */
-#include "geom.h"
 #define LEQ(x,y)	VertLeq((TESSvertex *)x, (TESSvertex *)y)
 #endif
 
@@ -69,110 +71,161 @@
 
 /* Since we support deletion the data structure is a little more
 * complicated than an ordinary heap.  "nodes" is the heap itself;
-* active nodes are stored in the range 1..pq->size.  When the
-* heap exceeds its allocated size (pq->max), its size doubles.
-* The children of node i are nodes 2i and 2i+1.
+* active nodes are stored in the range 1..pq->size.  The heap is
+* 4-ary, so sifting touches fewer levels and the children of a node
+* are adjacent in memory.  The children of node i are nodes
+* 4i-2 .. 4i+1, and the parent of node i is (i+2)/4.
 *
 * Each node stores an index into an array "handles".  Each handle
 * stores a key, plus a pointer back to the node which currently
 * represents that key (ie. nodes[handles[i].node].handle == i).
+*
+* Nodes carry a copy of their vertex's (s,t).  Vertices are never moved
+* while they are in the queue, so the copy stays valid and NodeLeq is
+* exactly VertLeq.
 */
 
+#define Node(pq,i)		(&(pq)->chunks[(i) >> PQ_CHUNK_SHIFT]->nodes[(i) & PQ_CHUNK_MASK])
+#define Handle(pq,h)	(&(pq)->chunks[(h) >> PQ_CHUNK_SHIFT]->handles[(h) & PQ_CHUNK_MASK])
+#define NodeLeq(x,y)	((x)->s < (y)->s || ((x)->s == (y)->s && (x)->t <= (y)->t))
 
-#define pqHeapMinimum(pq)	((pq)->handles[(pq)->nodes[1].handle].key)
+#define pqHeapMinimum(pq)	(Handle((pq), Node((pq), 1)->handle)->key)
 #define pqHeapIsEmpty(pq)	((pq)->size == 0)
 
 
+/* Adds one chunk of nodes and handles.  The chunk table is small and
+* rarely grows, so it is copied instead of relying on memrealloc.
+*/
+static int AddChunk( TESSalloc* alloc, PriorityQHeap *pq )
+{
+	PQchunk **chunks;
+	PQchunk *chunk;
+	int i;
+
+	if( pq->numChunks == pq->maxChunks ) {
+		chunks = (PQchunk **)alloc->memalloc( alloc->userData,
+			(size_t)(2 * pq->maxChunks * sizeof(pq->chunks[0])) );
+		if (chunks == NULL) return 0;
+		for( i = 0; i < pq->numChunks; ++i )
+			chunks[i] = pq->chunks[i];
+		alloc->memfree( alloc->userData, pq->chunks );
+		pq->chunks = chunks;
+		pq->maxChunks *= 2;
+	}
+	chunk = (PQchunk *)alloc->memalloc( alloc->userData, sizeof(PQchunk) );
+	if (chunk == NULL) return 0;
+	pq->chunks[pq->numChunks++] = chunk;
+	/* Index 0 is never used, so the first chunk holds one entry less. */
+	pq->max = pq->numChunks * PQ_CHUNK_SIZE - 1;
+	return 1;
+}
 
 /* really pqHeapNewPriorityQHeap */
-PriorityQHeap *pqHeapNewPriorityQ( TESSalloc* alloc, int size, int (*leq)(PQkey key1, PQkey key2) )
+PriorityQHeap *pqHeapNewPriorityQ( TESSalloc* alloc, int size )
 {
 	PriorityQHeap *pq = (PriorityQHeap *)alloc->memalloc( alloc->userData, sizeof( PriorityQHeap ));
 	if (pq == NULL) return NULL;
 
 	pq->size = 0;
-	pq->max = size;
-	pq->nodes = (PQnode *)alloc->memalloc( alloc->userData, (size + 1) * sizeof(pq->nodes[0]) );
-	if (pq->nodes == NULL) {
+	pq->max = 0;
+	pq->numChunks = 0;
+	pq->maxChunks = (size >> PQ_CHUNK_SHIFT) + 1;
+	pq->chunks = (PQchunk **)alloc->memalloc( alloc->userData, pq->maxChunks * sizeof(pq->chunks[0]) );
+	if (pq->chunks == NULL) {
 		alloc->memfree( alloc->userData, pq );
 		return NULL;
 	}
 
-	pq->handles = (PQhandleElem *)alloc->memalloc( alloc->userData, (size + 1) * sizeof(pq->handles[0]) );
-	if (pq->handles == NULL) {
-		alloc->memfree( alloc->userData, pq->nodes );
+	/* Only the first chunk is allocated up front; most sweeps insert
+	* few or no vertices after pqInit.
+	*/
+	if( ! AddChunk( alloc, pq )) {
+		alloc->memfree( alloc->userData, pq->chunks );
 		alloc->memfree( alloc->userData, pq );
 		return NULL;
 	}
 
 	pq->initialized = FALSE;
 	pq->freeList = 0;
-	pq->leq = leq;
 
-	pq->nodes[1].handle = 1;	/* so that Minimum() returns NULL */
-	pq->handles[1].key = NULL;
+	Node(pq, 1)->handle = 1;	/* so that Minimum() returns NULL */
+	Handle(pq, 1)->key = NULL;
 	return pq;
 }
 
+/* really pqHeapResetPriorityQHeap */
+static void pqHeapReset( PriorityQHeap *pq )
+{
+	pq->size = 0;
+	pq->initialized = FALSE;
+	pq->freeList = 0;
+
+	Node(pq, 1)->handle = 1;	/* so that Minimum() returns NULL */
+	Handle(pq, 1)->key = NULL;
+}
+
 /* really pqHeapDeletePriorityQHeap */
 void pqHeapDeletePriorityQ( TESSalloc* alloc, PriorityQHeap *pq )
 {
-	alloc->memfree( alloc->userData, pq->handles );
-	alloc->memfree( alloc->userData, pq->nodes );
+	int i;
+
+	for( i = 0; i < pq->numChunks; ++i )
+		alloc->memfree( alloc->userData, pq->chunks[i] );
+	alloc->memfree( alloc->userData, pq->chunks );
 	alloc->memfree( alloc->userData, pq );
 }
 
 
 static void FloatDown( PriorityQHeap *pq, int curr )
 {
-	PQnode *n = pq->nodes;
-	PQhandleElem *h = pq->handles;
-	PQhandle hCurr, hChild;
-	int child;
+	PQnode node = *Node(pq, curr);
+	PQnode *n, *best;
+	int child, first, last, i;
 
-	hCurr = n[curr].handle;
 	for( ;; ) {
-		child = curr << 1;
-		if( child < pq->size && LEQ( h[n[child+1].handle].key,
-			h[n[child].handle].key )) {
-				++child;
+		first = (curr << 2) - 2;
+		if( first > pq->size ) break;
+		last = first + 3;
+		if( last > pq->size ) last = pq->size;
+
+		child = first;
+		best = Node(pq, first);
+		for( i = first + 1; i <= last; ++i ) {
+			n = Node(pq, i);
+			if( NodeLeq( n, best )) {
+				best = n;
+				child = i;
+			}
 		}
+		if( NodeLeq( &node, best )) break;
 
-		assert(child <= pq->max);
-
-		hChild = n[child].handle;
-		if( child > pq->size || LEQ( h[hCurr].key, h[hChild].key )) {
-			n[curr].handle = hCurr;
-			h[hCurr].node = curr;
-			break;
-		}
-		n[curr].handle = hChild;
-		h[hChild].node = curr;
+		*Node(pq, curr) = *best;
+		Handle(pq, best->handle)->node = curr;
 		curr = child;
 	}
+	*Node(pq, curr) = node;
+	Handle(pq, node.handle)->node = curr;
 }
 
 
 static void FloatUp( PriorityQHeap *pq, int curr )
 {
-	PQnode *n = pq->nodes;
-	PQhandleElem *h = pq->handles;
-	PQhandle hCurr, hParent;
+	PQnode node = *Node(pq, curr);
+	PQnode *p;
 	int parent;
 
-	hCurr = n[curr].handle;
 	for( ;; ) {
-		parent = curr >> 1;
-		hParent = n[parent].handle;
-		if( parent == 0 || LEQ( h[hParent].key, h[hCurr].key )) {
-			n[curr].handle = hCurr;
-			h[hCurr].node = curr;
-			break;
-		}
-		n[curr].handle = hParent;
-		h[hParent].node = curr;
+		parent = (curr + 2) >> 2;
+		if( parent == 0 ) break;
+		p = Node(pq, parent);
+		if( NodeLeq( p, &node )) break;
+
+		*Node(pq, curr) = *p;
+		Handle(pq, p->handle)->node = curr;
 		curr = parent;
 	}
+	*Node(pq, curr) = node;
+	Handle(pq, node.handle)->node = curr;
 }
 
 /* really pqHeapInit */
@@ -194,45 +247,30 @@ PQhandle pqHeapInsert( TESSalloc* alloc, PriorityQHeap *pq, PQkey keyNew )
 {
 	int curr;
 	PQhandle free;
+	PQnode *n;
+	PQhandleElem *h;
 
-	curr = ++ pq->size;
-	if( (curr*2) > pq->max ) {
-		if (!alloc->memrealloc)
-		{
+	curr = pq->size + 1;
+	if( curr > pq->max ) {
+		if( ! AddChunk( alloc, pq ))
 			return INV_HANDLE;
-		}
-		else
-		{
-			PQnode *saveNodes= pq->nodes;
-			PQhandleElem *saveHandles= pq->handles;
-
-			// If the heap overflows, double its size.
-			pq->max <<= 1;
-			pq->nodes = (PQnode *)alloc->memrealloc( alloc->userData, pq->nodes, 
-				(size_t)((pq->max + 1) * sizeof( pq->nodes[0] )));
-			if (pq->nodes == NULL) {
-				pq->nodes = saveNodes;	// restore ptr to free upon return 
-				return INV_HANDLE;
-			}
-			pq->handles = (PQhandleElem *)alloc->memrealloc( alloc->userData, pq->handles,
-				(size_t) ((pq->max + 1) * sizeof( pq->handles[0] )));
-			if (pq->handles == NULL) {
-				pq->handles = saveHandles; // restore ptr to free upon return 
-				return INV_HANDLE;
-			}
-		}
 	}
+	pq->size = curr;
 
 	if( pq->freeList == 0 ) {
 		free = curr;
 	} else {
 		free = pq->freeList;
-		pq->freeList = pq->handles[free].node;
+		pq->freeList = Handle(pq, free)->node;
 	}
 
-	pq->nodes[curr].handle = free;
-	pq->handles[free].node = curr;
-	pq->handles[free].key = keyNew;
+	n = Node(pq, curr);
+	n->s = ((TESSvertex *)keyNew)->s;
+	n->t = ((TESSvertex *)keyNew)->t;
+	n->handle = free;
+	h = Handle(pq, free);
+	h->node = curr;
+	h->key = keyNew;
 
 	if( pq->initialized ) {
 		FloatUp( pq, curr );
@@ -244,17 +282,17 @@ PQhandle pqHeapInsert( TESSalloc* alloc, PriorityQHeap *pq, PQkey keyNew )
 /* really pqHeapExtractMin */
 PQkey pqHeapExtractMin( PriorityQHeap *pq )
 {
-	PQnode *n = pq->nodes;
-	PQhandleElem *h = pq->handles;
-	PQhandle hMin = n[1].handle;
-	PQkey min = h[hMin].key;
+	PQnode *root = Node(pq, 1);
+	PQhandle hMin = root->handle;
+	PQhandleElem *h = Handle(pq, hMin);
+	PQkey min = h->key;
 
 	if( pq->size > 0 ) {
-		n[1].handle = n[pq->size].handle;
-		h[n[1].handle].node = 1;
+		*root = *Node(pq, pq->size);
+		Handle(pq, root->handle)->node = 1;
 
-		h[hMin].key = NULL;
-		h[hMin].node = pq->freeList;
+		h->key = NULL;
+		h->node = pq->freeList;
 		pq->freeList = hMin;
 
 		if( -- pq->size > 0 ) {
@@ -267,25 +305,26 @@ PQkey pqHeapExtractMin( PriorityQHeap *pq )
 /* really pqHeapDelete */
 void pqHeapDelete( PriorityQHeap *pq, PQhandle hCurr )
 {
-	PQnode *n = pq->nodes;
-	PQhandleElem *h = pq->handles;
+	PQhandleElem *h = Handle(pq, hCurr);
+	PQnode *n;
 	int curr;
 
-	assert( hCurr >= 1 && hCurr <= pq->max && h[hCurr].key != NULL );
+	assert( hCurr >= 1 && hCurr <= pq->max && h->key != NULL );
 
-	curr = h[hCurr].node;
-	n[curr].handle = n[pq->size].handle;
-	h[n[curr].handle].node = curr;
+	curr = h->node;
+	n = Node(pq, curr);
+	*n = *Node(pq, pq->size);
+	Handle(pq, n->handle)->node = curr;
 
 	if( curr <= -- pq->size ) {
-		if( curr <= 1 || LEQ( h[n[curr>>1].handle].key, h[n[curr].handle].key )) {
+		if( curr <= 1 || NodeLeq( Node(pq, (curr+2) >> 2), n )) {
 			FloatDown( pq, curr );
 		} else {
 			FloatUp( pq, curr );
 		}
 	}
-	h[hCurr].key = NULL;
-	h[hCurr].node = pq->freeList;
+	h->key = NULL;
+	h->node = pq->freeList;
 	pq->freeList = hCurr;
 }
 
@@ -299,7 +338,7 @@ PriorityQ *pqNewPriorityQ( TESSalloc* alloc, int size, int (*leq)(PQkey key1, PQ
 	PriorityQ *pq = (PriorityQ *)alloc->memalloc( alloc->userData, sizeof( PriorityQ ));
 	if (pq == NULL) return NULL;
 
-	pq->heap = pqHeapNewPriorityQ( alloc, size, leq );
+	pq->heap = pqHeapNewPriorityQ( alloc, size );
 	if (pq->heap == NULL) {
 		alloc->memfree( alloc->userData, pq );
 		return NULL;
@@ -313,8 +352,13 @@ PriorityQ *pqNewPriorityQ( TESSalloc* alloc, int size, int (*leq)(PQkey key1, PQ
 		return NULL;
 	}
 
+	pq->order = NULL;
+	pq->orderMax = 0;
+	pq->sortItems = NULL;
+	pq->sortItemsMax = 0;
 	pq->size = 0;
 	pq->max = size; //INIT_SIZE;
+	pq->keysMax = size;
 	pq->initialized = FALSE;
 	pq->leq = leq;
 	
@@ -327,15 +371,222 @@ void pqDeletePriorityQ( TESSalloc* alloc, PriorityQ *pq )
 	assert(pq != NULL); 
 	if (pq->heap != NULL) pqHeapDeletePriorityQ( alloc, pq->heap );
 	if (pq->order != NULL) alloc->memfree( alloc->userData, pq->order );
+	if (pq->sortItems != NULL) alloc->memfree( alloc->userData, pq->sortItems );
 	if (pq->keys != NULL) alloc->memfree( alloc->userData, pq->keys );
 	alloc->memfree( alloc->userData, pq );
 }
 
+/* really tessPqSortReset */
+/* Empties the queue for reuse, keeping its arrays.  Returns 0 if room
+* for size keys could not be allocated.
+*/
+int pqReset( TESSalloc* alloc, PriorityQ *pq, int size )
+{
+	PQkey *keys;
+
+	if( size > pq->keysMax ) {
+		keys = (PQkey *)alloc->memalloc( alloc->userData, size * sizeof(pq->keys[0]) );
+		if (keys == NULL) return 0;
+		alloc->memfree( alloc->userData, pq->keys );
+		pq->keys = keys;
+		pq->keysMax = size;
+	}
+
+	pqHeapReset( pq->heap );
+	pq->size = 0;
+	pq->max = pq->keysMax;
+	pq->initialized = FALSE;
+	return 1;
+}
+
 
 #define LT(x,y)     (! LEQ(y,x))
 #define GT(x,y)     (! LEQ(x,y))
 #define Swap(a,b)   if(1){PQkey *tmp = *a; *a = *b; *b = tmp;}else
 
+#ifndef FOR_TRITE_TEST_PROGRAM
+
+/* Below this many keys the radix passes cost more than they save. */
+#define RADIX_MIN_SIZE	256
+#define RADIX_BITS		8
+#define RADIX_PASSES	(64 / RADIX_BITS)
+#define RADIX_MASK		((1 << RADIX_BITS) - 1)
+
+typedef struct SortItem { unsigned long long key; PQkey *ptr; } SortItem;
+
+/* Maps a float to an unsigned integer whose unsigned order agrees with
+* the float order: non-negative values get the sign bit set, negative
+* values have all bits flipped.  -0 is folded onto +0 first, since
+* VertLeq treats the two as equal.  Only valid when TESSreal is a 32-bit
+* float, see SortOrderByKeys().
+*/
+static unsigned int FloatKey( TESSreal x )
+{
+	union { TESSreal f; unsigned int u; } v;
+	v.f = x + (TESSreal)0;
+	return (v.u & 0x80000000u) ? ~v.u : (v.u | 0x80000000u);
+}
+
+/* Packs (s,t) into a 64-bit key so that comparing keys as integers is
+* exactly VertLeq, which compares s first and then t.  Returns 0 if
+* some coordinate is NaN, since VertLeq is not a total order then.
+*/
+static int BuildSortItems( PriorityQ *pq, SortItem *items )
+{
+	TESSvertex *v;
+	int i;
+
+	for( i = 0; i < pq->size; ++i ) {
+		v = (TESSvertex *)pq->keys[i];
+		if( v->s != v->s || v->t != v->t ) return 0;
+		items[i].key = ((unsigned long long)FloatKey( v->s ) << 32) | FloatKey( v->t );
+		items[i].ptr = &pq->keys[i];
+	}
+	return 1;
+}
+
+/* LSD radix sort of the items into ascending key order.  Returns the
+* buffer holding the result, which is either 'src' or 'dst'.
+*/
+static SortItem *RadixSort( SortItem *src, SortItem *dst, int n )
+{
+	unsigned int count[RADIX_PASSES][1 << RADIX_BITS];
+	SortItem *tmp;
+	unsigned int sum, c;
+	int i, d, shift;
+
+	for( d = 0; d < RADIX_PASSES; ++d ) {
+		for( i = 0; i <= RADIX_MASK; ++i )
+			count[d][i] = 0;
+	}
+	/* Histogram all digits in a single pass over the data. */
+	for( i = 0; i < n; ++i ) {
+		for( d = 0; d < RADIX_PASSES; ++d )
+			++count[d][(src[i].key >> (d * RADIX_BITS)) & RADIX_MASK];
+	}
+
+	for( d = 0; d < RADIX_PASSES; ++d ) {
+		shift = d * RADIX_BITS;
+		/* Skip digits shared by every key, e.g. the exponent bits of
+		* inputs that span a small coordinate range.
+		*/
+		if( count[d][(src[0].key >> shift) & RADIX_MASK] == (unsigned int)n )
+			continue;
+		sum = 0;
+		for( i = 0; i <= RADIX_MASK; ++i ) {
+			c = count[d][i];
+			count[d][i] = sum;
+			sum += c;
+		}
+		for( i = 0; i < n; ++i )
+			dst[count[d][(src[i].key >> shift) & RADIX_MASK]++] = src[i];
+		tmp = src; src = dst; dst = tmp;
+	}
+	return src;
+}
+
+#define KEY_LT(x,y)	((x).key < (y).key)
+#define KEY_GT(x,y)	((x).key > (y).key)
+#define KEY_SWAP(a,b)	do{SortItem tmp = *a; *a = *b; *b = tmp;}while(0)
+
+/* The quicksort of pqInit() over the packed keys.  Every comparison
+* has the same outcome as the VertLeq based one and the random pivots
+* are drawn from the same sequence, so the resulting permutation,
+* including the relative order of coincident vertices, is identical.
+*/
+static void QuickSortItems( SortItem *items, int n )
+{
+	SortItem *p, *r, *i, *j, piv;
+	struct { SortItem *p, *r; } Stack[50], *top = Stack;
+	unsigned int seed = 2016473283;
+
+	top->p = items; top->r = items + n - 1; ++top;
+	while( --top >= Stack ) {
+		p = top->p;
+		r = top->r;
+		while( r > p + 10 ) {
+			seed = seed * 1539415821 + 1;
+			i = p + seed % (r - p + 1);
+			piv = *i;
+			*i = *p;
+			*p = piv;
+			i = p - 1;
+			j = r + 1;
+			do {
+				do { ++i; } while( KEY_GT( *i, piv ));
+				do { --j; } while( KEY_LT( *j, piv ));
+				KEY_SWAP( i, j );
+			} while( i < j );
+			KEY_SWAP( i, j ); /* Undo last swap */
+			if( i - p < r - j ) {
+				top->p = j+1; top->r = r; ++top;
+				r = i-1;
+			} else {
+				top->p = p; top->r = i-1; ++top;
+				p = j+1;
+			}
+		}
+		/* Insertion sort small lists */
+		for( i = p+1; i <= r; ++i ) {
+			piv = *i;
+			for( j = i; j > p && KEY_LT( *(j-1), piv ); --j ) {
+				*j = *(j-1);
+			}
+			*j = piv;
+		}
+	}
+}
+
+/* Fills pq->order using keys packed into integers and stored next to
+* their pointers, so sorting neither calls through pq->leq nor chases
+* the key pointers.  Large inputs are radix sorted.  Every radix pass is
+* stable, so coincident vertices come out in the order they were
+* inserted, and the first of them is extracted first; it is the one
+* which survives the merge in tessComputeInterior().  Small inputs use
+* the quicksort of pqInit(), and get the same order as it.
+* Returns 0 if the keys could not be sorted this way.
+*/
+static int SortOrderByKeys( TESSalloc* alloc, PriorityQ *pq )
+{
+	SortItem *items, *sorted;
+	int n = pq->size;
+	int i;
+
+	/* Two coordinates must fit in a key, see FloatKey(). */
+	if( sizeof(TESSreal) != sizeof(unsigned int) || sizeof(unsigned int) != 4 ) {
+		return 0;
+	}
+
+	/* The scratch items are kept with the queue for the next pqInit. */
+	if( 2 * n > pq->sortItemsMax ) {
+		items = (SortItem *)alloc->memalloc( alloc->userData, (size_t)(2 * n * sizeof(SortItem)) );
+		if (items == NULL) return 0;
+		if (pq->sortItems != NULL) alloc->memfree( alloc->userData, pq->sortItems );
+		pq->sortItems = items;
+		pq->sortItemsMax = 2 * n;
+	}
+	items = pq->sortItems;
+
+	if( ! BuildSortItems( pq, items )) {
+		return 0;
+	}
+
+	if( n >= RADIX_MIN_SIZE ) {
+		sorted = RadixSort( items, items + n, n );
+		/* The order array is descending, minimum last. */
+		for( i = 0; i < n; ++i )
+			pq->order[n - 1 - i] = sorted[i].ptr;
+	} else {
+		QuickSortItems( items, n );
+		for( i = 0; i < n; ++i )
+			pq->order[i] = items[i].ptr;
+	}
+
+	return 1;
+}
+
+#endif
+
 /* really tessPqSortInit */
 int pqInit( TESSalloc* alloc, PriorityQ *pq )
 {
@@ -350,24 +601,35 @@ int pqInit( TESSalloc* alloc, PriorityQ *pq )
 	pq->order = (PQkey **)memAlloc( (size_t)
 	(pq->size * sizeof(pq->order[0])) );
 	*/
-	pq->order = (PQkey **)alloc->memalloc( alloc->userData,
-										  (size_t)((pq->size+1) * sizeof(pq->order[0])) );
-	/* the previous line is a patch to compensate for the fact that IBM */
-	/* machines return a null on a malloc of zero bytes (unlike SGI),   */
-	/* so we have to put in this defense to guard against a memory      */
-	/* fault four lines down. from fossum@austin.ibm.com.               */
-	if (pq->order == NULL) return 0;
+	if( pq->order == NULL || pq->size+1 > pq->orderMax ) {
+		if (pq->order != NULL) alloc->memfree( alloc->userData, pq->order );
+		pq->order = (PQkey **)alloc->memalloc( alloc->userData,
+											  (size_t)((pq->size+1) * sizeof(pq->order[0])) );
+		/* the previous line is a patch to compensate for the fact that IBM */
+		/* machines return a null on a malloc of zero bytes (unlike SGI),   */
+		/* so we have to put in this defense to guard against a memory      */
+		/* fault four lines down. from fossum@austin.ibm.com.               */
+		if (pq->order == NULL) return 0;
+		pq->orderMax = pq->size+1;
+	}
 
-	p = pq->order;
-	r = p + pq->size - 1;
-	for( piv = pq->keys, i = p; i <= r; ++piv, ++i ) {
-		*i = piv;
+#ifndef FOR_TRITE_TEST_PROGRAM
+	if( pq->size > 0 && SortOrderByKeys( alloc, pq ) ) {
+		top = Stack;
+	} else
+#endif
+	{
+		p = pq->order;
+		r = p + pq->size - 1;
+		for( piv = pq->keys, i = p; i <= r; ++piv, ++i ) {
+			*i = piv;
+		}
+		top->p = p; top->r = r; ++top;
 	}
 
 	/* Sort the indirect pointers in descending order,
 	* using randomized Quicksort
 	*/
-	top->p = p; top->r = r; ++top;
 	while( --top >= Stack ) {
 		p = top->p;
 		r = top->r;
@@ -443,6 +705,7 @@ PQhandle pqInsert( TESSalloc* alloc, PriorityQ *pq, PQkey keyNew )
 				pq->keys = saveKey;  // restore ptr to free upon return 
 				return INV_HANDLE;
 			}
+			pq->keysMax = pq->max;
 		}
 	}
 	assert(curr != INV_HANDLE); 
@@ -222,7 +222,7 @@ static ActiveRegion *AddRegionBelow( TESStesselator *tess,
 	return regNew;
 }
 
-static int IsWindingInside( TESStesselator *tess, int n )
+int tessIsWindingInside( TESStesselator *tess, int n )
 {
 	switch( tess->windingRule ) {
 		case TESS_WINDING_ODD:
@@ -247,7 +247,7 @@ static int IsWindingInside( TESStesselator *tess, int n )
 static void ComputeWinding( TESStesselator *tess, ActiveRegion *reg )
 {
 	reg->windingNumber = RegionAbove(reg)->windingNumber + reg->eUp->winding;
-	reg->inside = IsWindingInside( tess, reg->windingNumber );
+	reg->inside = tessIsWindingInside( tess, reg->windingNumber );
 }
 
 
@@ -262,9 +262,19 @@ static void FinishRegion( TESStesselator *tess, ActiveRegion *reg )
 {
 	TESShalfEdge *e = reg->eUp;
 	TESSface *f = e->Lface;
+	ActiveRegion *r;
 
 	f->inside = reg->inside;
 	f->anEdge = e;   /* optimization for tessMeshTessellateMonoRegion() */
+
+	/* The face comes from the contour of the nearest input edge above it,
+	* skipping the edges the sweep has added.
+	*/
+	if( tess->provenance ) {
+		for( r = reg; r->eUp->contour == TESS_UNDEF && ! r->sentinel; r = RegionAbove(r) )
+			;
+		f->contour = r->eUp->contour;
+	}
 	DeleteRegion( tess, reg );
 }
 
@@ -372,13 +382,13 @@ static void AddRightEdges( TESStesselator *tess, ActiveRegion *regUp,
 		}
 		/* Compute the winding number and "inside" flag for the new regions */
 		reg->windingNumber = regPrev->windingNumber - e->winding;
-		reg->inside = IsWindingInside( tess, reg->windingNumber );
+		reg->inside = tessIsWindingInside( tess, reg->windingNumber );
 
 		/* Check for two outgoing edges with same slope -- process these
 		* before any intersection tests (see example in tessComputeInterior).
 		*/
 		regPrev->dirty = TRUE;
-		if( ! firstTime && CheckForRightSplice( tess, regPrev )) {
+		if( ! firstTime && ! tess->simpleContours && CheckForRightSplice( tess, regPrev )) {
 			AddWinding( e, ePrev );
 			DeleteRegion( tess, regPrev );
 			if ( !tessMeshDelete( tess->mesh, ePrev ) ) longjmp(tess->env,1);
@@ -422,12 +432,46 @@ static void VertexWeights( TESSvertex *isect, TESSvertex *org, TESSvertex *dst,
 
 	weights[0] = (TESSreal)0.5 * t2 / (t1 + t2);
 	weights[1] = (TESSreal)0.5 * t1 / (t1 + t2);
+}
+
+static TESSreal ParentData( TESStesselator *tess, TESSindex row, int i )
+{
+	return row != TESS_UNDEF ? tess->vertexData[row * tess->vertexDataSize + i] : 0;
+}
 
-	for(int i=0; i<MAX_DIMENSIONS;i++) {
-		isect->coords[i] += weights[0]*org->coords[i] + weights[1]*dst->coords[i];
+static void InterpolateVertexData( TESStesselator *tess, TESSindex row )
+{
+	TESSinterp *ip = &tess->interp[row - tess->interpBase];
+	TESSreal *data = &tess->vertexData[row * tess->vertexDataSize];
+	int i;
+
+	for( i = 0; i < tess->vertexDataSize; i++ ) {
+		data[i] = ip->weights[0]*ParentData( tess, ip->parents[0], i ) + ip->weights[1]*ParentData( tess, ip->parents[1], i );
+		data[i] += ip->weights[2]*ParentData( tess, ip->parents[2], i ) + ip->weights[3]*ParentData( tess, ip->parents[3], i );
 	}
+	ip->resolved = TRUE;
 }
 
+static int ReserveInterp( TESStesselator *tess )
+{
+	TESSinterp *interp;
+	int max, i;
+
+	if( tess->interpCount < tess->interpMax )
+		return 1;
+
+	max = tess->interpMax > 0 ? tess->interpMax * 2 : 64;
+	interp = (TESSinterp *)tess->alloc.memalloc( tess->alloc.userData, sizeof(TESSinterp) * max );
+	if (interp == NULL) return 0;
+	if( tess->interp != NULL ) {
+		for( i = 0; i < tess->interpCount; ++i )
+			interp[i] = tess->interp[i];
+		tess->alloc.memfree( tess->alloc.userData, tess->interp );
+	}
+	tess->interp = interp;
+	tess->interpMax = max;
+	return 1;
+}
 
 static void GetIntersectData( TESStesselator *tess, TESSvertex *isect,
 							 TESSvertex *orgUp, TESSvertex *dstUp,
@@ -436,17 +480,71 @@ static void GetIntersectData( TESStesselator *tess, TESSvertex *isect,
  * We've computed a new intersection point, now we need a "data" pointer
  * from the user so that we can refer to this new vertex in the
  * rendering callbacks.
+ *
+ * Many intersection vertices are merged or discarded later on, so only
+ * the parents and weights are recorded here; the coordinates are
+ * interpolated by tessResolveVertexData() once the mesh is final.
  */
 {
-	TESSreal weights[4];
-	TESS_NOTUSED( tess );
+	TESSinterp *ip;
+	TESSindex parents[4];
 
-	for(int i=0; i<MAX_DIMENSIONS;i++) {
-			isect->coords[i] = 0;
-	}
+	if ( !tessReserveVertexData( tess, 1 ) ) longjmp(tess->env,1);
+	if ( !ReserveInterp( tess ) ) longjmp(tess->env,1);
+	isect->data = tess->vertexDataCount++;
 	isect->idx = TESS_UNDEF;
-	VertexWeights( isect, orgUp, dstUp, &weights[0] );
-	VertexWeights( isect, orgLo, dstLo, &weights[2] );
+	assert( isect->data == tess->interpBase + tess->interpCount );
+
+	ip = &tess->interp[tess->interpCount++];
+	ip->parents[0] = orgUp->data;
+	ip->parents[1] = dstUp->data;
+	ip->parents[2] = orgLo->data;
+	ip->parents[3] = dstLo->data;
+	ip->needed = FALSE;
+	ip->resolved = FALSE;
+	VertexWeights( isect, orgUp, dstUp, &ip->weights[0] );
+	VertexWeights( isect, orgLo, dstLo, &ip->weights[2] );
+
+	/* The combine callback needs the coordinates right away. */
+	if( tess->combine != NULL ) {
+		InterpolateVertexData( tess, isect->data );
+		parents[0] = orgUp->idx;
+		parents[1] = dstUp->idx;
+		parents[2] = orgLo->idx;
+		parents[3] = dstLo->idx;
+		isect->idx = tess->combine( tess->combineUserData, parents, ip->weights,
+									tessVertexData( tess, isect ), tess->vertexDataSize );
+	}
+}
+
+void tessResolveVertexData( TESStesselator *tess )
+/*
+* Parents are created before their children, so they always have lower
+* rows.  One backward pass marks every record which the remaining
+* vertices depend on, and one forward pass interpolates just those.
+*/
+{
+	TESSvertex *v, *vHead = &tess->mesh->vHead;
+	TESSinterp *ip;
+	int i, j;
+
+	for( v = vHead->next; v != vHead; v = v->next ) {
+		if( v->data >= tess->interpBase )
+			tess->interp[v->data - tess->interpBase].needed = TRUE;
+	}
+	for( i = tess->interpCount - 1; i >= 0; --i ) {
+		ip = &tess->interp[i];
+		if( ! ip->needed || ip->resolved ) continue;
+		for( j = 0; j < 4; ++j ) {
+			if( ip->parents[j] >= tess->interpBase )
+				tess->interp[ip->parents[j] - tess->interpBase].needed = TRUE;
+		}
+	}
+	for( i = 0; i < tess->interpCount; ++i ) {
+		ip = &tess->interp[i];
+		if( ip->needed && ! ip->resolved )
+			InterpolateVertexData( tess, tess->interpBase + i );
+	}
 }
 
 static int CheckForRightSplice( TESStesselator *tess, ActiveRegion *regUp )
@@ -710,6 +808,45 @@ static int CheckForIntersect( TESStesselator *tess, ActiveRegion *regUp )
 	return FALSE;
 }
 
+#ifndef NDEBUG
+static void CheckSimple( TESStesselator *tess, ActiveRegion *regUp )
+/*
+* Stands in for the splice and intersection checks when the contours
+* are declared simple (tess->simpleContours).  Where CheckForRightSplice()
+* and CheckForLeftSplice() repair the dictionary order of the upper and
+* lower edge of "regUp" at their Org and Dst vertices, this fails the
+* tesselation: an end of one edge on or beyond the other edge means that
+* they cross or touch, and two edges with the same ends overlap.
+*/
+{
+	ActiveRegion *regLo = RegionBelow(regUp);
+	TESShalfEdge *eUp = regUp->eUp;
+	TESShalfEdge *eLo = regLo->eUp;
+	int ok = ( eUp->Dst != eLo->Dst || eUp->Org != eLo->Org );
+
+	if( ok && eUp->Dst != eLo->Dst ) {
+		if( VertLeq( eUp->Dst, eLo->Dst )) {
+			ok = EdgeSign( eUp->Dst, eLo->Dst, eUp->Org ) < 0;
+		} else {
+			ok = EdgeSign( eLo->Dst, eUp->Dst, eLo->Org ) > 0;
+		}
+	}
+	if( ok && eUp->Org != eLo->Org ) {
+		if( VertLeq( eUp->Org, eLo->Org )) {
+			ok = EdgeSign( eLo->Dst, eUp->Org, eLo->Org ) > 0;
+		} else {
+			ok = EdgeSign( eUp->Dst, eLo->Org, eUp->Org ) < 0;
+		}
+	}
+	if( ! ok ) {
+		tess->simpleViolation = TRUE;
+		longjmp(tess->env,1);
+	}
+}
+#else
+#define CheckSimple( tess, regUp )
+#endif
+
 static void WalkDirtyRegions( TESStesselator *tess, ActiveRegion *regUp )
 /*
 * When the upper or lower edge of any region changes, the region is
@@ -741,7 +878,10 @@ static void WalkDirtyRegions( TESStesselator *tess, ActiveRegion *regUp )
 		eUp = regUp->eUp;
 		eLo = regLo->eUp;
 
-		if( eUp->Dst != eLo->Dst ) {
+		if( tess->simpleContours ) {
+			/* Nothing to repair, at most something to report. */
+			CheckSimple( tess, regUp );
+		} else if( eUp->Dst != eLo->Dst ) {
 			/* Check that the edge ordering is obeyed at the Dst vertices. */
 			if( CheckForLeftSplice( tess, regUp )) {
 
@@ -762,7 +902,7 @@ static void WalkDirtyRegions( TESStesselator *tess, ActiveRegion *regUp )
 				}
 			}
 		}
-		if( eUp->Org != eLo->Org ) {
+		if( eUp->Org != eLo->Org && ! tess->simpleContours ) {
 			if(    eUp->Dst != eLo->Dst
 				&& ! regUp->fixUpperEdge && ! regLo->fixUpperEdge
 				&& (eUp->Dst == tess->event || eLo->Dst == tess->event) )
@@ -838,7 +978,7 @@ static void ConnectRightVertex( TESStesselator *tess, ActiveRegion *regUp,
 	TESShalfEdge *eLo = regLo->eUp;
 	int degenerate = FALSE;
 
-	if( eUp->Dst != eLo->Dst ) {
+	if( eUp->Dst != eLo->Dst && ! tess->simpleContours ) {
 		(void) CheckForIntersect( tess, regUp );
 	}
 
@@ -1118,8 +1258,14 @@ static void InitEdgeDict( TESStesselator *tess )
 	TESSreal w, h;
 	TESSreal smin, smax, tmin, tmax;
 
-	tess->dict = dictNewDict( &tess->alloc, tess, (int (*)(void *, DictKey, DictKey)) EdgeLeq );
-	if (tess->dict == NULL) longjmp(tess->env,1);
+	/* The dictionary and its regions are kept from the previous sweep. */
+	if (tess->dict == NULL) {
+		tess->dict = dictNewDict( &tess->alloc, tess, tess->dictType, (int (*)(void *, DictKey, DictKey)) EdgeLeq );
+		if (tess->dict == NULL) longjmp(tess->env,1);
+	} else {
+		dictReset( tess->dict, tess->dictType );
+		bucketReset( tess->regionPool );
+	}
 
 	w = (tess->bmax[0] - tess->bmin[0]);
 	h = (tess->bmax[1] - tess->bmin[1]);
@@ -1157,7 +1303,6 @@ static void DoneEdgeDict( TESStesselator *tess )
 		DeleteRegion( tess, reg );
 		/*    tessMeshDelete( reg->eUp );*/
 	}
-	dictDeleteDict( &tess->alloc, tess->dict );
 }
 
 
@@ -1209,11 +1354,19 @@ static int InitPriorityQ( TESStesselator *tess )
 	for( v = vHead->next; v != vHead; v = v->next ) {
 		vertexCount++;
 	}
-	/* Make sure there is enough space for sentinels. */
-	vertexCount += MAX( 8, tess->alloc.extraVertices );
+	/* Make sure there is enough space for sentinels, and unless the
+	* contours are declared simple, for intersection vertices.
+	*/
+	vertexCount += MAX( 8, tess->simpleContours ? 0 : tess->alloc.extraVertices );
 	
-	pq = tess->pq = pqNewPriorityQ( &tess->alloc, vertexCount, (int (*)(PQkey, PQkey)) tesvertLeq );
-	if (pq == NULL) return 0;
+	/* The queue is kept from the previous sweep, see tessDeleteTess(). */
+	if (tess->pq == NULL) {
+		tess->pq = pqNewPriorityQ( &tess->alloc, vertexCount, (int (*)(PQkey, PQkey)) tesvertLeq );
+		if (tess->pq == NULL) return 0;
+	} else if ( !pqReset( &tess->alloc, tess->pq, vertexCount ) ) {
+		return 0;
+	}
+	pq = tess->pq;
 
 	vHead = &tess->mesh->vHead;
 	for( v = vHead->next; v != vHead; v = v->next ) {
@@ -1222,8 +1375,6 @@ static int InitPriorityQ( TESStesselator *tess )
 			break;
 	}
 	if (v != vHead || !pqInit( &tess->alloc, pq ) ) {
-		pqDeletePriorityQ( &tess->alloc, tess->pq );
-		tess->pq = NULL;
 		return 0;
 	}
 
@@ -1231,12 +1382,6 @@ static int InitPriorityQ( TESStesselator *tess )
 }
 
 
-static void DonePriorityQ( TESStesselator *tess )
-{
-	pqDeletePriorityQ( &tess->alloc, tess->pq );
-}
-
-
 static int RemoveDegenerateFaces( TESStesselator *tess, TESSmesh *mesh )
 /*
 * Delete any degenerate faces with only two edges.  WalkDirtyRegions()
@@ -1321,7 +1466,6 @@ int tessComputeInterior( TESStesselator *tess )
 	tess->event = ((ActiveRegion *) dictKey( dictMin( tess->dict )))->eUp->Org;
 	DebugEvent( tess );
 	DoneEdgeDict( tess );
-	DonePriorityQ( tess );
 
 	if ( !RemoveDegenerateFaces( tess, tess->mesh ) ) return 0;
 	tessMeshCheckMesh( tess->mesh );
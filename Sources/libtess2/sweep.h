@@ -42,6 +42,16 @@
 */
 int tessComputeInterior( TESStesselator *tess );
 
+/* tessResolveVertexData( tess ) interpolates the coordinates of the
+* intersection vertices which are still part of the mesh.
+*/
+void tessResolveVertexData( TESStesselator *tess );
+
+/* tessIsWindingInside( tess, n ) returns whether a region with winding
+* number n is inside the polygon, according to tess->windingRule.
+*/
+int tessIsWindingInside( TESStesselator *tess, int n );
+
 
 /* The following is here *only* for access by debugging routines */
 
@@ -37,8 +37,11 @@
 #include "mesh.h"
 #include "sweep.h"
 #include "geom.h"
+#include "vcache.h"
 #include <string.h>
 #include <math.h>
+#include <limits.h>
+#include <float.h>
 #include <stdio.h>
 #include <stdlib.h>
 
@@ -82,7 +85,8 @@ static int ShortAxis( TESSreal v[3] )
 
 static void ComputeNormal( TESStesselator *tess, TESSreal norm[3] )
 {
-	TESSvertex *v, *v1, *v2;
+	TESSvertex *v;
+	TESSreal *p, *p1, *p2;
 	TESSreal c, tLen2, maxLen2;
 	TESSreal maxVal[3], minVal[3], d1[3], d2[3], tNorm[3];
 	TESSvertex *maxVert[3], *minVert[3];
@@ -91,7 +95,7 @@ static void ComputeNormal( TESStesselator *tess, TESSreal norm[3] )
 
 	v = vHead->next;
 	for( i = 0; i < 3; ++i ) {
-		c = v->coords[i];
+		c = tessVertexData( tess, v )[i];
 		minVal[i] = c;
 		minVert[i] = v;
 		maxVal[i] = c;
@@ -100,7 +104,7 @@ static void ComputeNormal( TESStesselator *tess, TESSreal norm[3] )
 
 	for( v = vHead->next; v != vHead; v = v->next ) {
 		for( i = 0; i < 3; ++i ) {
-			c = v->coords[i];
+			c = tessVertexData( tess, v )[i];
 			if( c < minVal[i] ) { minVal[i] = c; minVert[i] = v; }
 			if( c > maxVal[i] ) { maxVal[i] = c; maxVert[i] = v; }
 		}
@@ -122,15 +126,16 @@ static void ComputeNormal( TESStesselator *tess, TESSreal norm[3] )
 	* (Length of normal == twice the triangle area)
 	*/
 	maxLen2 = 0;
-	v1 = minVert[i];
-	v2 = maxVert[i];
-	d1[0] = v1->coords[0] - v2->coords[0];
-	d1[1] = v1->coords[1] - v2->coords[1];
-	d1[2] = v1->coords[2] - v2->coords[2];
+	p1 = tessVertexData( tess, minVert[i] );
+	p2 = tessVertexData( tess, maxVert[i] );
+	d1[0] = p1[0] - p2[0];
+	d1[1] = p1[1] - p2[1];
+	d1[2] = p1[2] - p2[2];
 	for( v = vHead->next; v != vHead; v = v->next ) {
-		d2[0] = v->coords[0] - v2->coords[0];
-		d2[1] = v->coords[1] - v2->coords[1];
-		d2[2] = v->coords[2] - v2->coords[2];
+		p = tessVertexData( tess, v );
+		d2[0] = p[0] - p2[0];
+		d2[1] = p[1] - p2[1];
+		d2[2] = p[2] - p2[2];
 		tNorm[0] = d1[1]*d2[2] - d1[2]*d2[1];
 		tNorm[1] = d1[2]*d2[0] - d1[0]*d2[2];
 		tNorm[2] = d1[0]*d2[1] - d1[1]*d2[0];
@@ -257,8 +262,8 @@ void tessProjectPolygon( TESStesselator *tess )
 	/* Project the vertices onto the sweep plane */
 	for( v = vHead->next; v != vHead; v = v->next )
 	{
-		v->s = Dot( v->coords, sUnit );
-		v->t = Dot( v->coords, tUnit );
+		v->s = Dot( tessVertexData( tess, v ), sUnit );
+		v->t = Dot( tessVertexData( tess, v ), tUnit );
 	}
 	if( computedNormal ) {
 		CheckOrientation( tess );
@@ -513,6 +518,13 @@ TESStesselator* tessNewTess( TESSalloc* alloc )
 	tess->bmax[1] = 0;
     
     tess->noEmptyPolygons = FALSE;
+	tess->dictType = TESS_DICT_SKIPLIST;
+	tess->optimizeVertexCache = FALSE;
+	tess->delaunay = FALSE;
+	tess->simpleContours = FALSE;
+	tess->simpleViolation = FALSE;
+	tess->meshletMaxVertices = 64;
+	tess->meshletMaxTriangles = 126;
 
 	tess->windingRule = TESS_WINDING_ODD;
 
@@ -525,15 +537,63 @@ TESStesselator* tessNewTess( TESSalloc* alloc )
 
 	// Initialize to begin polygon.
 	tess->mesh = NULL;
+	tess->spareMesh = NULL;
+	tess->dict = NULL;
+	tess->pq = NULL;
 
 	tess->outOfMemory = 0;
 	tess->vertexIndexCounter = 0;
+	tess->convexCount = 0;
+
+	tess->vertexData = 0;
+	tess->vertexDataSize = 0;
+	tess->vertexDataCount = 0;
+	tess->vertexDataMax = 0;
+
+	tess->interp = 0;
+	tess->interpBase = 0;
+	tess->interpCount = 0;
+	tess->interpMax = 0;
+
+	tess->combine = NULL;
+	tess->combineUserData = NULL;
+	tess->triangleCallback = NULL;
+	tess->triangleUserData = NULL;
 	
 	tess->vertices = 0;
 	tess->vertexIndices = 0;
 	tess->vertexCount = 0;
 	tess->elements = 0;
 	tess->elementCount = 0;
+	tess->indexCount = 0;
+	tess->verticesMax = 0;
+	tess->vertexIndicesMax = 0;
+	tess->elementsMax = 0;
+	tess->provenance = FALSE;
+	tess->elementMetrics = FALSE;
+	tess->metrics = NULL;
+	tess->metricsMax = 0;
+	tess->contourCounter = 0;
+	tess->elementContours = NULL;
+	tess->edgeContours = NULL;
+	tess->elementContoursMax = 0;
+	tess->edgeContoursMax = 0;
+	tess->appendOutput = FALSE;
+	tess->vertexBase = 0;
+	tess->elementBase = 0;
+	tess->indexBase = 0;
+	tess->drawRanges = NULL;
+	tess->drawRangeCount = 0;
+	tess->drawRangesMax = 0;
+	tess->meshlets = NULL;
+	tess->meshletCount = 0;
+	tess->meshletVertices = NULL;
+	tess->meshletTriangles = NULL;
+	tess->meshletsMax = 0;
+	tess->meshletVerticesMax = 0;
+	tess->meshletTrianglesMax = 0;
+	tess->scratch = NULL;
+	tess->scratchMax = 0;
 
 	return tess;
 }
@@ -549,6 +609,18 @@ void tessDeleteTess( TESStesselator *tess )
 		tessMeshDeleteMesh( &alloc, tess->mesh );
 		tess->mesh = NULL;
 	}
+	if( tess->spareMesh != NULL ) {
+		tessMeshDeleteMesh( &alloc, tess->spareMesh );
+		tess->spareMesh = NULL;
+	}
+	if( tess->dict != NULL ) {
+		dictDeleteDict( &alloc, tess->dict );
+		tess->dict = NULL;
+	}
+	if( tess->pq != NULL ) {
+		pqDeletePriorityQ( &alloc, tess->pq );
+		tess->pq = NULL;
+	}
 	if (tess->vertices != NULL) {
 		alloc.memfree( alloc.userData, tess->vertices );
 		tess->vertices = 0;
@@ -561,6 +633,46 @@ void tessDeleteTess( TESStesselator *tess )
 		alloc.memfree( alloc.userData, tess->elements );
 		tess->elements = 0;
 	}
+	if (tess->elementContours != NULL) {
+		alloc.memfree( alloc.userData, tess->elementContours );
+		tess->elementContours = NULL;
+	}
+	if (tess->edgeContours != NULL) {
+		alloc.memfree( alloc.userData, tess->edgeContours );
+		tess->edgeContours = NULL;
+	}
+	if (tess->metrics != NULL) {
+		alloc.memfree( alloc.userData, tess->metrics );
+		tess->metrics = NULL;
+	}
+	if (tess->drawRanges != NULL) {
+		alloc.memfree( alloc.userData, tess->drawRanges );
+		tess->drawRanges = NULL;
+	}
+	if (tess->meshlets != NULL) {
+		alloc.memfree( alloc.userData, tess->meshlets );
+		tess->meshlets = NULL;
+	}
+	if (tess->meshletVertices != NULL) {
+		alloc.memfree( alloc.userData, tess->meshletVertices );
+		tess->meshletVertices = NULL;
+	}
+	if (tess->meshletTriangles != NULL) {
+		alloc.memfree( alloc.userData, tess->meshletTriangles );
+		tess->meshletTriangles = NULL;
+	}
+	if (tess->scratch != NULL) {
+		alloc.memfree( alloc.userData, tess->scratch );
+		tess->scratch = NULL;
+	}
+	if (tess->vertexData != NULL) {
+		alloc.memfree( alloc.userData, tess->vertexData );
+		tess->vertexData = 0;
+	}
+	if (tess->interp != NULL) {
+		alloc.memfree( alloc.userData, tess->interp );
+		tess->interp = 0;
+	}
 
 	alloc.memfree( alloc.userData, tess );
 }
@@ -575,333 +687,2377 @@ static TESSindex GetNeighbourFace(TESShalfEdge* edge)
 	return edge->Rface->n;
 }
 
-void OutputPolymesh( TESStesselator *tess, TESSmesh *mesh, int elementType, int polySize, int vertexSize )
+static void CopyVertexData( TESStesselator *tess, TESSvertex *v, TESSreal *dst, int vertexSize )
 {
-	TESSvertex* v = 0;
-	TESSface* f = 0;
-	TESShalfEdge* edge = 0;
-	int maxFaceCount = 0;
-	int maxVertexCount = 0;
-	int faceVerts, i;
-	TESSindex *elements = 0;
-	TESSreal *vert;
+	TESSreal *src;
+	int i = 0;
 
-	// Assume that the input data is triangles now.
-	// Try to merge as many polygons as possible
-	if (polySize > 3)
-	{
-		if (!tessMeshMergeConvexFaces( mesh, polySize ))
-		{
-			tess->outOfMemory = 1;
-			return;
+	if( v->data != TESS_UNDEF ) {
+		src = tessVertexData( tess, v );
+		for( ; i < vertexSize && i < tess->vertexDataSize; ++i )
+			dst[i] = src[i];
+	}
+	for( ; i < vertexSize; ++i )
+		dst[i] = 0;
+}
+
+/* Returns an output buffer with room for count items, reusing buf when it
+* is large enough.  Returns NULL if out of memory, leaving buf untouched.
+*/
+static void *ReserveOutput( TESStesselator *tess, void *buf, int *max, int count, size_t itemSize )
+{
+	void *p;
+
+	if ( buf != NULL && count <= *max )
+		return buf;
+
+	/* Never ask for zero bytes, some allocators return NULL for that. */
+	p = tess->alloc.memalloc( tess->alloc.userData, itemSize * (count > 0 ? count : 1) );
+	if ( !p )
+		return NULL;
+	if ( buf != NULL )
+		tess->alloc.memfree( tess->alloc.userData, buf );
+	*max = count;
+	return p;
+}
+
+/* As ReserveOutput(), but keeps the first keep items of buf, as when
+* appending.  The buffer grows at least twice as large, so that appending
+* many small outputs stays linear.
+*/
+static void *GrowOutput( TESStesselator *tess, void *buf, int *max, int keep, int count, size_t itemSize )
+{
+	void *p;
+	int newMax;
+
+	if ( keep == 0 )
+		return ReserveOutput( tess, buf, max, count, itemSize );
+	if ( buf != NULL && keep + count <= *max )
+		return buf;
+
+	newMax = *max * 2;
+	if ( newMax < keep + count )
+		newMax = keep + count;
+	p = tess->alloc.memalloc( tess->alloc.userData, itemSize * newMax );
+	if ( !p )
+		return NULL;
+	if ( buf != NULL ) {
+		memcpy( p, buf, itemSize * keep );
+		tess->alloc.memfree( tess->alloc.userData, buf );
+	}
+	*max = newMax;
+	return p;
+}
+
+/* Where the output functions write: the caller's buffers described by a
+* TESSoutputLayout, or tess->vertices, tess->vertexIndices and tess->elements.
+*/
+typedef struct OutputTarget {
+	unsigned char *vertices;	/* NULL to skip the vertices */
+	int vertexStride;
+	int positionOffset;
+	int vertexIndexOffset;		/* -1 if the index is not interleaved */
+	TESSindex *vertexIndices;	/* separate index array, or NULL */
+	int vertexFormat;
+	TESSreal quantScale[MAX_DIMENSIONS];	/* TESS_VERTEX_INT16: q = (x - offset) * scale */
+	TESSreal quantOffset[MAX_DIMENSIONS];
+	void *elements;
+	int indexType;
+	TESSindex indexOffset;		/* added to vertex indices when appending */
+	TESSindex *elementContours;	/* provenance, or NULL, see SelectElementDataTarget() */
+	TESSindex *edgeContours;
+	TESSreal *metrics;			/* element metrics, or NULL, rows metricsStride apart */
+	int metricsStride;
+	int vertexCapacity;			/* room for vertices and indices, checked by */
+	int indexCapacity;			/* single pass output, see SelectBoundedOutputTarget() */
+	int inLayout;				/* writing to the caller's buffers */
+} OutputTarget;
+
+/* Converts to IEEE 754 half precision, rounding to nearest even. */
+static unsigned short FloatToHalf( float value )
+{
+	union { float f; unsigned int u; } bits;
+	unsigned int sign, mant, half, rem, halfway;
+	int exp, shift;
+
+	bits.f = value;
+	sign = (bits.u >> 16) & 0x8000;
+	exp = (int)((bits.u >> 23) & 0xff) - 127 + 15;
+	mant = bits.u & 0x7fffff;
+
+	if ( exp >= 31 ) {
+		/* Overflow, infinity or NaN. */
+		if ( ((bits.u >> 23) & 0xff) == 0xff && mant != 0 )
+			return (unsigned short)(sign | 0x7e00);
+		return (unsigned short)(sign | 0x7c00);
+	}
+	if ( exp <= 0 ) {
+		/* Subnormal, or too small even for that. */
+		if ( exp < -10 )
+			return (unsigned short)sign;
+		mant |= 0x800000;
+		shift = 14 - exp;
+		half = mant >> shift;
+		rem = mant & ((1u << shift) - 1);
+		halfway = 1u << (shift - 1);
+		if ( rem > halfway || (rem == halfway && (half & 1)) )
+			half++;
+		return (unsigned short)(sign | half);
+	}
+
+	/* A carry out of the mantissa correctly bumps the exponent. */
+	half = ((unsigned int)exp << 10) | (mant >> 13);
+	rem = mant & 0x1fff;
+	if ( rem > 0x1000 || (rem == 0x1000 && (half & 1)) )
+		half++;
+	return (unsigned short)(sign | half);
+}
+
+static short Quantize( TESSreal x, TESSreal offset, TESSreal scale )
+{
+	TESSreal q = (x - offset) * scale;
+
+	if ( q >= 32767 )
+		return 32767;
+	if ( q <= -32767 )
+		return -32767;
+	return (short)(q < 0 ? q - 0.5f : q + 0.5f);
+}
+
+/* Stores output vertex n from its coordinates and original index.  The
+* caller's offsets and stride need not be aligned, so all of it is copied
+* bytewise.
+*/
+static void StoreCoords( const OutputTarget *out, int n, const TESSreal *coords, TESSindex idx, int vertexSize )
+{
+	unsigned char *dst;
+	short q;
+	unsigned short h;
+	int i;
+
+	if ( out->vertices != NULL ) {
+		dst = out->vertices + (size_t)n * out->vertexStride;
+		if ( out->vertexFormat == TESS_VERTEX_INT16 ) {
+			for ( i = 0; i < vertexSize; ++i ) {
+				q = Quantize( coords[i], out->quantOffset[i], out->quantScale[i] );
+				memcpy( dst + out->positionOffset + i * sizeof(q), &q, sizeof(q) );
+			}
+		} else if ( out->vertexFormat == TESS_VERTEX_FLOAT16 ) {
+			for ( i = 0; i < vertexSize; ++i ) {
+				h = FloatToHalf( coords[i] );
+				memcpy( dst + out->positionOffset + i * sizeof(h), &h, sizeof(h) );
+			}
+		} else {
+			memcpy( dst + out->positionOffset, coords, sizeof(TESSreal) * vertexSize );
 		}
+		if ( out->vertexIndexOffset >= 0 )
+			memcpy( dst + out->vertexIndexOffset, &idx, sizeof(idx) );
 	}
+	if ( out->vertexIndices != NULL )
+		out->vertexIndices[n] = idx;
+}
 
-	// Mark unused
-	for ( v = mesh->vHead.next; v != &mesh->vHead; v = v->next )
-		v->n = TESS_UNDEF;
+static void StoreVertex( TESStesselator *tess, const OutputTarget *out, int n, TESSvertex *v, int vertexSize )
+{
+	TESSreal coords[MAX_DIMENSIONS];
 
-	// Create unique IDs for all vertices and faces.
-	for ( f = mesh->fHead.next; f != &mesh->fHead; f = f->next )
+	if ( out->vertices != NULL )
+		CopyVertexData( tess, v, coords, vertexSize );
+	StoreCoords( out, n, coords, v->idx, vertexSize );
+}
+
+static void StoreElement( const OutputTarget *out, int i, TESSindex value )
+{
+	/* TESS_UNDEF narrows to 0xffff. */
+	if ( out->indexType == TESS_INDEX_UINT16 )
+		((unsigned short *)out->elements)[i] = (unsigned short)value;
+	else
+		((TESSindex *)out->elements)[i] = value;
+}
+
+static void StoreIndex( const OutputTarget *out, int i, TESSindex value )
+{
+	if ( value != TESS_UNDEF )
+		value += out->indexOffset;
+	StoreElement( out, i, value );
+}
+
+/* Sets up the TESS_VERTEX_INT16 mapping of each coordinate from the bounds of
+* the mesh vertices, which enclose the output vertices, to -32767..32767,
+* and its inverse in the layout.
+*/
+static void SetQuantization( TESStesselator *tess, TESSoutputLayout *layout, OutputTarget *out, int vertexSize )
+{
+	TESSreal bmin[MAX_DIMENSIONS], bmax[MAX_DIMENSIONS], coords[MAX_DIMENSIONS];
+	TESSvertex *v;
+	int i;
+
+	for ( i = 0; i < MAX_DIMENSIONS; ++i ) {
+		layout->dequantScale[i] = 1;
+		layout->dequantOffset[i] = 0;
+	}
+	if ( layout->vertexFormat != TESS_VERTEX_INT16 )
+		return;
+
+	for ( i = 0; i < vertexSize; ++i ) {
+		bmin[i] = FLT_MAX;
+		bmax[i] = -FLT_MAX;
+	}
+	for ( v = tess->mesh->vHead.next; v != &tess->mesh->vHead; v = v->next ) {
+		CopyVertexData( tess, v, coords, vertexSize );
+		for ( i = 0; i < vertexSize; ++i ) {
+			if ( coords[i] < bmin[i] ) bmin[i] = coords[i];
+			if ( coords[i] > bmax[i] ) bmax[i] = coords[i];
+		}
+	}
+
+	for ( i = 0; i < vertexSize; ++i ) {
+		if ( bmin[i] > bmax[i] )
+			bmin[i] = bmax[i] = 0;
+		out->quantOffset[i] = (bmin[i] + bmax[i]) * 0.5f;
+		out->quantScale[i] = bmax[i] > bmin[i] ? 32767 / ((bmax[i] - bmin[i]) * 0.5f) : 0;
+		layout->dequantOffset[i] = out->quantOffset[i];
+		layout->dequantScale[i] = ((bmax[i] - bmin[i]) * 0.5f) / 32767;
+	}
+}
+
+/* Returns whether tessTesselateInto() can use the layout at all: the
+* formats must be known, and the coordinates and the original index of a
+* vertex must lie apart within its vertexStride bytes.
+*/
+static int LayoutValid( const TESSoutputLayout *layout, int vertexSize )
+{
+	size_t coordsEnd, indexEnd;
+
+	if ( layout->indexType != TESS_INDEX_INT32 && layout->indexType != TESS_INDEX_UINT16 )
+		return 0;
+	if ( layout->vertices == NULL )
+		return 1;
+
+	if (vertexSize < 2)
+		vertexSize = 2;
+	if (vertexSize > MAX_DIMENSIONS)
+		vertexSize = MAX_DIMENSIONS;
+	if ( layout->vertexFormat == TESS_VERTEX_FLOAT32 )
+		coordsEnd = sizeof(TESSreal) * vertexSize;
+	else if ( layout->vertexFormat == TESS_VERTEX_INT16 || layout->vertexFormat == TESS_VERTEX_FLOAT16 )
+		coordsEnd = sizeof(short) * vertexSize;
+	else
+		return 0;
+
+	if ( layout->vertexStride <= 0 || layout->positionOffset < 0 )
+		return 0;
+	coordsEnd += (size_t)layout->positionOffset;
+	if ( coordsEnd > (size_t)layout->vertexStride )
+		return 0;
+	if ( layout->vertexIndexOffset >= 0 ) {
+		indexEnd = (size_t)layout->vertexIndexOffset + sizeof(TESSindex);
+		if ( indexEnd > (size_t)layout->vertexStride )
+			return 0;
+		if ( (size_t)layout->vertexIndexOffset < coordsEnd && (size_t)layout->positionOffset < indexEnd )
+			return 0;
+	}
+	return 1;
+}
+
+/* Returns whether the output fits the caller's buffers.  faceIndices is
+* set when the indices also hold face numbers, as those of
+* TESS_CONNECTED_POLYGONS do, which must then stay below 0xffff too.
+*/
+static int LayoutFits( const TESSoutputLayout *layout, int faceIndices )
+{
+	if ( layout->vertices != NULL && layout->vertexCount > layout->vertexCapacity )
+		return 0;
+	if ( layout->indexCount > layout->indexCapacity )
+		return 0;
+	if ( layout->indexType == TESS_INDEX_UINT16 && layout->vertexCount > 0xffff )
+		return 0;
+	if ( layout->indexType == TESS_INDEX_UINT16 && faceIndices && layout->elementCount >= 0xffff )
+		return 0;
+	return 1;
+}
+
+/* Chooses where the output goes once tess->vertexCount and tess->elementCount
+* are known.  The caller's buffers are used when the output fits, otherwise
+* the internal arrays, which are grown as needed.  faceIndices is as for
+* LayoutFits().  Returns 0 if out of memory.
+*/
+static int SelectOutputTarget( TESStesselator *tess, TESSoutputLayout *layout, OutputTarget *out,
+							   int vertexSize, int indexCount, int faceIndices )
+{
+	void *p;
+
+	tess->indexCount = indexCount;
+	if ( layout != NULL ) {
+		layout->vertexCount = tess->vertexCount;
+		layout->elementCount = tess->elementCount;
+		layout->indexCount = indexCount;
+		SetQuantization( tess, layout, out, vertexSize );
+		if ( LayoutFits( layout, faceIndices ) ) {
+			out->vertices = (unsigned char *)layout->vertices;
+			out->vertexFormat = layout->vertexFormat;
+			out->vertexStride = layout->vertexStride;
+			out->positionOffset = layout->positionOffset;
+			out->vertexIndexOffset = layout->vertexIndexOffset;
+			out->vertexIndices = NULL;
+			out->elements = layout->elements;
+			out->indexType = layout->indexType;
+			out->indexOffset = 0;
+			out->elementContours = NULL;
+			out->edgeContours = NULL;
+			out->metrics = NULL;
+			out->inLayout = 1;
+			return 1;
+		}
+	}
+
+	/* When appending, the output goes after that of the previous calls. */
+	p = GrowOutput( tess, tess->elements, &tess->elementsMax,
+					tess->indexBase, indexCount, sizeof(TESSindex) );
+	if (!p)
+		return 0;
+	tess->elements = (TESSindex*)p;
+
+	p = GrowOutput( tess, tess->vertices, &tess->verticesMax,
+					tess->vertexBase * vertexSize, tess->vertexCount * vertexSize, sizeof(TESSreal) );
+	if (!p)
+		return 0;
+	tess->vertices = (TESSreal*)p;
+
+	p = GrowOutput( tess, tess->vertexIndices, &tess->vertexIndicesMax,
+					tess->vertexBase, tess->vertexCount, sizeof(TESSindex) );
+	if (!p)
+		return 0;
+	tess->vertexIndices = (TESSindex*)p;
+
+	out->vertices = (unsigned char *)&tess->vertices[tess->vertexBase * vertexSize];
+	out->vertexStride = vertexSize * (int)sizeof(TESSreal);
+	out->positionOffset = 0;
+	out->vertexIndexOffset = -1;
+	out->vertexFormat = TESS_VERTEX_FLOAT32;
+	out->vertexIndices = &tess->vertexIndices[tess->vertexBase];
+	out->elements = &tess->elements[tess->indexBase];
+	out->indexType = TESS_INDEX_INT32;
+	out->indexOffset = tess->vertexBase;
+	out->elementContours = NULL;
+	out->edgeContours = NULL;
+	out->metrics = NULL;
+	out->inLayout = 0;
+	return 1;
+}
+
+/* Makes room for the element metrics of count more elements.  The metrics
+* are stored as TESS_METRIC_COUNT rows, so growing moves each row.
+* Returns 0 if out of memory.
+*/
+static int ReserveElementMetrics( TESStesselator *tess, int count )
+{
+	int keep = tess->elementBase;
+	int newMax, m;
+	TESSreal *p;
+
+	if ( tess->metrics != NULL && keep + count <= tess->metricsMax )
+		return 1;
+
+	newMax = keep > 0 ? tess->metricsMax * 2 : 0;
+	if ( newMax < keep + count )
+		newMax = keep + count;
+	newMax = (newMax + 3) & ~3;		/* keeps every row 16 byte aligned */
+	if ( newMax == 0 )
+		newMax = 4;
+	p = (TESSreal*)tess->alloc.memalloc( tess->alloc.userData, sizeof(TESSreal) * TESS_METRIC_COUNT * newMax );
+	if ( !p )
+		return 0;
+	if ( tess->metrics != NULL ) {
+		for ( m = 0; m < TESS_METRIC_COUNT && keep > 0; ++m )
+			memcpy( &p[m * newMax], &tess->metrics[m * tess->metricsMax], sizeof(TESSreal) * keep );
+		tess->alloc.memfree( tess->alloc.userData, tess->metrics );
+	}
+	tess->metrics = p;
+	tess->metricsMax = newMax;
+	return 1;
+}
+
+/* Adds the per element arrays which are enabled to out: the provenance,
+* tess->elementCount element contours and edgeCount edge contours after
+* edgeBase edges of previous calls when appending, and the element metrics.
+* Returns 0 if out of memory.
+*/
+static int SelectElementDataTarget( TESStesselator *tess, OutputTarget *out, int edgeBase, int edgeCount )
+{
+	void *p;
+
+	if ( tess->provenance ) {
+		p = GrowOutput( tess, tess->elementContours, &tess->elementContoursMax,
+						tess->elementBase, tess->elementCount, sizeof(TESSindex) );
+		if (!p)
+			return 0;
+		tess->elementContours = (TESSindex*)p;
+
+		p = GrowOutput( tess, tess->edgeContours, &tess->edgeContoursMax,
+						edgeBase, edgeCount, sizeof(TESSindex) );
+		if (!p)
+			return 0;
+		tess->edgeContours = (TESSindex*)p;
+
+		out->elementContours = &tess->elementContours[tess->elementBase];
+		out->edgeContours = &tess->edgeContours[edgeBase];
+	}
+
+	if ( tess->elementMetrics ) {
+		if ( !ReserveElementMetrics( tess, tess->elementCount ) )
+			return 0;
+		out->metrics = &tess->metrics[tess->elementBase];
+		out->metricsStride = tess->metricsMax;
+	}
+	return 1;
+}
+
+/* Stores the TessElementMetric values of face f as element n.  The area and
+* centroid are those of the vector area of the face's fan, so that they hold
+* for 3D input too, unlike tessFaceArea() which works in the sweep plane.
+*/
+static void StoreElementMetrics( TESStesselator *tess, const OutputTarget *out, int n, TESSface *f )
+{
+	TESSreal v0[3], a[3], b[3], cross[3];
+	TESSreal normal[3] = { 0, 0, 0 };
+	TESSreal sum[3] = { 0, 0, 0 };
+	TESSreal centroid[3] = { 0, 0, 0 };
+	TESSreal bmin[3], bmax[3];
+	TESSreal len, w, wsum = 0;
+	TESShalfEdge *e;
+	int i, count = 0;
+
+	CopyVertexData( tess, f->anEdge->Org, v0, 3 );
+	for ( i = 0; i < 3; ++i )
+		bmin[i] = bmax[i] = v0[i];
+
+	e = f->anEdge;
+	do
 	{
-		f->n = TESS_UNDEF;
-		if( !f->inside ) continue;
-        
-        if( tess->noEmptyPolygons )
-        {
-            TESSreal area = tessFaceArea(f);
-            if( ABS(area) < __FLT_EPSILON__ )
-            {
-                continue;
-            }
-        }
+		CopyVertexData( tess, e->Org, a, 3 );
+		CopyVertexData( tess, e->Dst, b, 3 );
+		for ( i = 0; i < 3; ++i ) {
+			if ( a[i] < bmin[i] ) bmin[i] = a[i];
+			if ( a[i] > bmax[i] ) bmax[i] = a[i];
+			sum[i] += a[i];
+			a[i] -= v0[i];
+			b[i] -= v0[i];
+		}
+		normal[0] += a[1]*b[2] - a[2]*b[1];
+		normal[1] += a[2]*b[0] - a[0]*b[2];
+		normal[2] += a[0]*b[1] - a[1]*b[0];
+		count++;
+		e = e->Lnext;
+	}
+	while ( e != f->anEdge );
 
-		edge = f->anEdge;
-		faceVerts = 0;
+	len = sqrtf( normal[0]*normal[0] + normal[1]*normal[1] + normal[2]*normal[2] );
+
+	/* Weigh the centroids of the fan triangles by their area along the normal. */
+	if ( len > 0 ) {
+		e = f->anEdge;
 		do
 		{
-			v = edge->Org;
-			if ( v->n == TESS_UNDEF )
-			{
-				v->n = maxVertexCount;
-				maxVertexCount++;
+			CopyVertexData( tess, e->Org, a, 3 );
+			CopyVertexData( tess, e->Dst, b, 3 );
+			for ( i = 0; i < 3; ++i ) {
+				a[i] -= v0[i];
+				b[i] -= v0[i];
 			}
-			faceVerts++;
-			edge = edge->Lnext;
+			cross[0] = a[1]*b[2] - a[2]*b[1];
+			cross[1] = a[2]*b[0] - a[0]*b[2];
+			cross[2] = a[0]*b[1] - a[1]*b[0];
+			w = cross[0]*normal[0] + cross[1]*normal[1] + cross[2]*normal[2];
+			for ( i = 0; i < 3; ++i )
+				centroid[i] += w * (a[i] + b[i]);
+			wsum += w;
+			e = e->Lnext;
 		}
-		while (edge != f->anEdge);
-		
-		assert( faceVerts <= polySize );
+		while ( e != f->anEdge );
+	}
+	for ( i = 0; i < 3; ++i )
+		centroid[i] = wsum != 0 ? v0[i] + centroid[i] / (3 * wsum) : sum[i] / count;
 
-		f->n = maxFaceCount;
-		++maxFaceCount;
+	for ( i = 0; i < 3; ++i ) {
+		out->metrics[(TESS_METRIC_MIN_X + i) * out->metricsStride + n] = bmin[i];
+		out->metrics[(TESS_METRIC_MAX_X + i) * out->metricsStride + n] = bmax[i];
+		out->metrics[(TESS_METRIC_CENTROID_X + i) * out->metricsStride + n] = centroid[i];
 	}
+	out->metrics[TESS_METRIC_AREA * out->metricsStride + n] = len * 0.5f;
+}
 
-	tess->elementCount = maxFaceCount;
-	if (elementType == TESS_CONNECTED_POLYGONS)
-		maxFaceCount *= 2;
-	tess->elements = (TESSindex*)tess->alloc.memalloc( tess->alloc.userData,
-													  sizeof(TESSindex) * maxFaceCount * polySize );
-	if (!tess->elements)
-	{
-		tess->outOfMemory = 1;
-		return;
+/* Single pass variant of SelectOutputTarget, used when the output is written
+* while it is being numbered.  The bounds come from the live mesh counts,
+* which include the outside faces and the vertices only they use, so the
+* internal arrays may be larger than the output.  Bounds beyond the caller's
+* buffers are cut down to them, as the output itself often fits; the writes
+* are then checked against out->vertexCapacity and out->indexCapacity, and
+* only when those run out does the caller count the output first.
+* SetOutputCounts records the exact sizes after.  Returns 0 if out of memory.
+*/
+static int SelectBoundedOutputTarget( TESStesselator *tess, TESSoutputLayout *layout, OutputTarget *out,
+									  int vertexSize, int maxVertexCount, int maxElementCount, int maxIndexCount )
+{
+	if ( layout != NULL ) {
+		if ( layout->vertices != NULL && maxVertexCount > layout->vertexCapacity )
+			maxVertexCount = layout->vertexCapacity > 0 ? layout->vertexCapacity : 0;
+		if ( layout->indexType == TESS_INDEX_UINT16 && maxVertexCount > 0xffff )
+			maxVertexCount = 0xffff;
+		if ( maxIndexCount > layout->indexCapacity )
+			maxIndexCount = layout->indexCapacity > 0 ? layout->indexCapacity : 0;
 	}
-	
 	tess->vertexCount = maxVertexCount;
-	tess->vertices = (TESSreal*)tess->alloc.memalloc( tess->alloc.userData,
-													 sizeof(TESSreal) * tess->vertexCount * vertexSize );
-	if (!tess->vertices)
-	{
-		tess->outOfMemory = 1;
-		return;
+	tess->elementCount = maxElementCount;
+	if ( !SelectOutputTarget( tess, layout, out, vertexSize, maxIndexCount, 0 ) )
+		return 0;
+	out->vertexCapacity = maxVertexCount;
+	out->indexCapacity = maxIndexCount;
+	return 1;
+}
+
+static void SetOutputCounts( TESStesselator *tess, TESSoutputLayout *layout,
+							 int vertexCount, int elementCount, int indexCount )
+{
+	tess->vertexCount = vertexCount;
+	tess->elementCount = elementCount;
+	tess->indexCount = indexCount;
+	if ( layout != NULL ) {
+		layout->vertexCount = vertexCount;
+		layout->elementCount = elementCount;
+		layout->indexCount = indexCount;
 	}
+}
+
+/* Returns 1 if face f is part of the polygon output. */
+static int IsOutputFace( TESStesselator *tess, TESSface *f )
+{
+	if ( !f->inside )
+		return 0;
+	if ( tess->noEmptyPolygons && ABS(tessFaceArea(f)) < __FLT_EPSILON__ )
+		return 0;
+	return 1;
+}
 
-	tess->vertexIndices = (TESSindex*)tess->alloc.memalloc( tess->alloc.userData,
-														    sizeof(TESSindex) * tess->vertexCount );
-	if (!tess->vertexIndices)
+/* Stores face f, and its neighbours for TESS_CONNECTED_POLYGONS.
+* Returns the next index position.
+*/
+static int StorePolygon( TESStesselator *tess, const OutputTarget *out, int nindices, TESSface *f,
+						 int elementType, int polySize )
+{
+	TESShalfEdge* edge;
+	int faceVerts = 0;
+	int i;
+
+	// Store polygon
+	edge = f->anEdge;
+	do
 	{
-		tess->outOfMemory = 1;
-		return;
+		StoreIndex( out, nindices++, edge->Org->n );
+		faceVerts++;
+		edge = edge->Lnext;
 	}
-	
-	// Output vertices.
-	for ( v = mesh->vHead.next; v != &mesh->vHead; v = v->next )
+	while (edge != f->anEdge);
+	assert( faceVerts <= polySize );
+	// Fill unused.
+	for (i = faceVerts; i < polySize; ++i)
+		StoreIndex( out, nindices++, TESS_UNDEF );
+
+	if ( out->metrics != NULL )
+		StoreElementMetrics( tess, out, f->n, f );
+
+	// Store the contours it comes from
+	if ( out->elementContours != NULL )
 	{
-		if ( v->n != TESS_UNDEF )
+		TESSindex *edgeContours = &out->edgeContours[f->n * polySize];
+		out->elementContours[f->n] = f->contour;
+		i = 0;
+		edge = f->anEdge;
+		do
 		{
-			// Store coordinate
-			vert = &tess->vertices[v->n*vertexSize];
-			for (int ii=0; ii<vertexSize; ii++) {
-				vert[ii] = v->coords[ii];
-			}
-			// Store vertex index.
-			tess->vertexIndices[v->n] = v->idx;
+			edgeContours[i++] = edge->contour;
+			edge = edge->Lnext;
 		}
+		while (edge != f->anEdge);
+		for (; i < polySize; ++i)
+			edgeContours[i] = TESS_UNDEF;
 	}
 
-	// Output indices.
-	elements = tess->elements;
-	for ( f = mesh->fHead.next; f != &mesh->fHead; f = f->next )
+	// Store polygon connectivity
+	if ( elementType == TESS_CONNECTED_POLYGONS )
 	{
-		if ( !f->inside ) continue;
-        
-        if( tess->noEmptyPolygons )
-        {
-            TESSreal area = tessFaceArea(f);
-            if( ABS(area) < __FLT_EPSILON__ )
-            {
-                continue;
-            }
-        }
-		
-		// Store polygon
 		edge = f->anEdge;
-		faceVerts = 0;
 		do
 		{
-			v = edge->Org;
-			*elements++ = v->n;
-			faceVerts++;
+			StoreIndex( out, nindices++, GetNeighbourFace( edge ) );
 			edge = edge->Lnext;
 		}
 		while (edge != f->anEdge);
 		// Fill unused.
 		for (i = faceVerts; i < polySize; ++i)
-			*elements++ = TESS_UNDEF;
-
-		// Store polygon connectivity
-		if ( elementType == TESS_CONNECTED_POLYGONS )
-		{
-			edge = f->anEdge;
-			do
-			{
-				*elements++ = GetNeighbourFace( edge );
-				edge = edge->Lnext;
-			}
-			while (edge != f->anEdge);
-			// Fill unused.
-			for (i = faceVerts; i < polySize; ++i)
-				*elements++ = TESS_UNDEF;
-		}
+			StoreIndex( out, nindices++, TESS_UNDEF );
 	}
+	return nindices;
 }
 
-void OutputContours( TESStesselator *tess, TESSmesh *mesh, int vertexSize )
+/* Reorders the numbered faces (f->n) for the post-transform vertex cache,
+* see vcache.h, and renumbers the vertices (v->n) in order of first use.
+* Returns the faces in their new order, or NULL if out of memory.
+*/
+static TESSface **OrderFacesForVertexCache( TESStesselator *tess, TESSmesh *mesh, int polySize )
 {
-	TESSface *f = 0;
-	TESShalfEdge *edge = 0;
-	TESShalfEdge *start = 0;
-	TESSreal *verts = 0;
-	TESSindex *elements = 0;
-	TESSindex *vertInds = 0;
-	int startVert = 0;
-	int vertCount = 0;
-
-	tess->vertexCount = 0;
-	tess->elementCount = 0;
+	int faceCount = tess->elementCount;
+	int vertexCount = tess->vertexCount;
+	TESSface **faceList;
+	TESSindex *faces, *remap;
+	int *order;
+	TESSvertex *v;
+	TESSface *f;
+	TESShalfEdge *edge;
+	int i, k, n;
+	size_t size;
+
+	size = sizeof(TESSface*) * faceCount
+		 + sizeof(TESSindex) * ((size_t)faceCount * polySize + vertexCount)
+		 + sizeof(int) * faceCount
+		 + vcacheScratchSize( faceCount, polySize, vertexCount );
+	if ( size > INT_MAX )
+		return NULL;
+	faceList = (TESSface **)ReserveOutput( tess, tess->scratch, &tess->scratchMax, (int)size, 1 );
+	if ( !faceList )
+		return NULL;
+	tess->scratch = faceList;
+	faces = (TESSindex *)&faceList[faceCount];
+	remap = &faces[faceCount * polySize];
+	order = (int *)&remap[vertexCount];
 
 	for ( f = mesh->fHead.next; f != &mesh->fHead; f = f->next )
 	{
-		if ( !f->inside ) continue;
-
-		start = edge = f->anEdge;
+		if ( f->n == TESS_UNDEF ) continue;
+		faceList[f->n] = f;
+		i = 0;
+		edge = f->anEdge;
 		do
 		{
-			++tess->vertexCount;
+			faces[f->n * polySize + i++] = edge->Org->n;
 			edge = edge->Lnext;
 		}
-		while ( edge != start );
-
-		++tess->elementCount;
+		while (edge != f->anEdge);
+		for (; i < polySize; ++i)
+			faces[f->n * polySize + i] = TESS_UNDEF;
 	}
 
-	tess->elements = (TESSindex*)tess->alloc.memalloc( tess->alloc.userData,
-													  sizeof(TESSindex) * tess->elementCount * 2 );
-	if (!tess->elements)
+	vcacheOrderFaces( faces, faceCount, polySize, vertexCount, &order[faceCount], order );
+
+	for ( i = 0; i < vertexCount; ++i )
+		remap[i] = TESS_UNDEF;
+	n = 0;
+	for ( k = 0; k < faceCount; ++k )
 	{
-		tess->outOfMemory = 1;
-		return;
+		for ( i = 0; i < polySize; ++i )
+		{
+			TESSindex old = faces[order[k] * polySize + i];
+			if ( old == TESS_UNDEF ) break;
+			if ( remap[old] == TESS_UNDEF )
+				remap[old] = n++;
+		}
+		faceList[order[k]]->n = k;
 	}
-	
-	tess->vertices = (TESSreal*)tess->alloc.memalloc( tess->alloc.userData,
-													  sizeof(TESSreal) * tess->vertexCount * vertexSize );
-	if (!tess->vertices)
+	for ( v = mesh->vHead.next; v != &mesh->vHead; v = v->next )
 	{
-		tess->outOfMemory = 1;
-		return;
+		if ( v->n != TESS_UNDEF )
+			v->n = remap[v->n];
 	}
-
-	tess->vertexIndices = (TESSindex*)tess->alloc.memalloc( tess->alloc.userData,
-														    sizeof(TESSindex) * tess->vertexCount );
-	if (!tess->vertexIndices)
+	for ( f = mesh->fHead.next; f != &mesh->fHead; f = f->next )
 	{
-		tess->outOfMemory = 1;
-		return;
+		if ( f->n != TESS_UNDEF )
+			faceList[f->n] = f;
 	}
-	
-	verts = tess->vertices;
-	elements = tess->elements;
-	vertInds = tess->vertexIndices;
+	return faceList;
+}
 
-	startVert = 0;
+/* Numbers and stores the TESS_POLYGONS faces in a single pass.  Returns 0,
+* leaving the numbering unfinished, if out runs out of room.
+*/
+static int StorePolygons( TESStesselator *tess, TESSmesh *mesh, const OutputTarget *out, int polySize,
+						  int vertexSize, int *vertexCount, int *faceCount, int *nindices )
+{
+	TESSvertex* v;
+	TESSface* f;
+	TESShalfEdge* edge;
+
+	for ( f = mesh->fHead.next; f != &mesh->fHead; f = f->next )
+	{
+		f->n = TESS_UNDEF;
+		if ( !IsOutputFace( tess, f ) ) continue;
+		if ( *nindices + polySize > out->indexCapacity )
+			return 0;
+
+		edge = f->anEdge;
+		do
+		{
+			v = edge->Org;
+			if ( v->n == TESS_UNDEF )
+			{
+				if ( *vertexCount == out->vertexCapacity )
+					return 0;
+				v->n = *vertexCount;
+				StoreVertex( tess, out, (*vertexCount)++, v, vertexSize );
+			}
+			edge = edge->Lnext;
+		}
+		while (edge != f->anEdge);
+
+		f->n = (*faceCount)++;
+		*nindices = StorePolygon( tess, out, *nindices, f, TESS_POLYGONS, polySize );
+	}
+	return 1;
+}
+
+/* Returns 1 if the output was written to the caller's buffers. */
+static int OutputPolymesh( TESStesselator *tess, TESSmesh *mesh, int elementType, int polySize, int vertexSize,
+						   TESSoutputLayout *layout )
+{
+	TESSvertex* v = 0;
+	TESSface* f = 0;
+	TESShalfEdge* edge = 0;
+	int maxFaceCount = 0;
+	int maxVertexCount = 0;
+	TESSface** faceList = 0;
+	int faceVerts, i, rc;
+	int nindices = 0;
+	OutputTarget out;
+
+	// Assume that the input data is triangles now.
+	// Try to merge as many polygons as possible
+	if (polySize > 3)
+	{
+		if (!tessMeshMergeConvexFaces( mesh, polySize ))
+		{
+			tess->outOfMemory = 1;
+			return 0;
+		}
+	}
+
+	// Mark unused
+	for ( v = mesh->vHead.next; v != &mesh->vHead; v = v->next )
+		v->n = TESS_UNDEF;
+
+	// Plain polygons are numbered and stored in a single pass. Connected
+	// polygons need all face IDs, and vertex cache ordering all faces, first.
+	if ( elementType == TESS_POLYGONS && !tess->optimizeVertexCache )
+	{
+		rc = SelectBoundedOutputTarget( tess, layout, &out, vertexSize, mesh->vertexCount,
+										mesh->faceCount, mesh->faceCount * polySize );
+		if ( rc && !SelectElementDataTarget( tess, &out, tess->elementBase * polySize, mesh->faceCount * polySize ) )
+			rc = 0;
+		if ( rc == 0 )
+		{
+			tess->outOfMemory = 1;
+			return 0;
+		}
+		if ( StorePolygons( tess, mesh, &out, polySize, vertexSize, &maxVertexCount, &maxFaceCount, &nindices ) )
+		{
+			SetOutputCounts( tess, layout, maxVertexCount, maxFaceCount, nindices );
+			return out.inLayout;
+		}
+
+		// The caller's buffers are too small, count first.
+		for ( v = mesh->vHead.next; v != &mesh->vHead; v = v->next )
+			v->n = TESS_UNDEF;
+		maxVertexCount = 0;
+		maxFaceCount = 0;
+		nindices = 0;
+	}
+
+	// Create unique IDs for all vertices and faces.
+	for ( f = mesh->fHead.next; f != &mesh->fHead; f = f->next )
+	{
+		f->n = TESS_UNDEF;
+		if ( !IsOutputFace( tess, f ) ) continue;
+
+		edge = f->anEdge;
+		faceVerts = 0;
+		do
+		{
+			v = edge->Org;
+			if ( v->n == TESS_UNDEF )
+			{
+				v->n = maxVertexCount;
+				maxVertexCount++;
+			}
+			faceVerts++;
+			edge = edge->Lnext;
+		}
+		while (edge != f->anEdge);
+		
+		assert( faceVerts <= polySize );
+
+		f->n = maxFaceCount;
+		++maxFaceCount;
+	}
+
+	tess->elementCount = maxFaceCount;
+	tess->vertexCount = maxVertexCount;
+
+	if ( tess->optimizeVertexCache && maxFaceCount > 1 )
+	{
+		faceList = OrderFacesForVertexCache( tess, mesh, polySize );
+		if ( !faceList )
+		{
+			tess->outOfMemory = 1;
+			return 0;
+		}
+	}
+
+	if (elementType == TESS_CONNECTED_POLYGONS)
+		maxFaceCount *= 2;
+
+	if ( !SelectOutputTarget( tess, layout, &out, vertexSize, maxFaceCount * polySize,
+							  elementType == TESS_CONNECTED_POLYGONS )
+		|| !SelectElementDataTarget( tess, &out, tess->elementBase * polySize, tess->elementCount * polySize ) )
+	{
+		tess->outOfMemory = 1;
+		return 0;
+	}
+	
+	// Output vertices.
+	for ( v = mesh->vHead.next; v != &mesh->vHead; v = v->next )
+	{
+		if ( v->n != TESS_UNDEF )
+			StoreVertex( tess, &out, v->n, v, vertexSize );
+	}
+
+	// Output indices.
+	if ( faceList != NULL )
+	{
+		for ( i = 0; i < tess->elementCount; ++i )
+			nindices = StorePolygon( tess, &out, nindices, faceList[i], elementType, polySize );
+	}
+	else
+	{
+		for ( f = mesh->fHead.next; f != &mesh->fHead; f = f->next )
+		{
+			if ( f->n != TESS_UNDEF )
+				nindices = StorePolygon( tess, &out, nindices, f, elementType, polySize );
+		}
+	}
+
+	return out.inLayout;
+}
+
+/* Stores the boundary contours.  Returns 0 if out runs out of room. */
+static int StoreContours( TESStesselator *tess, TESSmesh *mesh, const OutputTarget *out, int vertexSize,
+						  int *nverts, int *nindices )
+{
+	TESSface *f;
+	TESShalfEdge *edge, *start;
+	int startVert = 0;
+	int vertCount;
 
 	for ( f = mesh->fHead.next; f != &mesh->fHead; f = f->next )
 	{
 		if ( !f->inside ) continue;
+		if ( *nindices + 2 > out->indexCapacity )
+			return 0;
+
+		if ( out->elementContours != NULL )
+			out->elementContours[*nindices / 2] = f->contour;
+		if ( out->metrics != NULL )
+			StoreElementMetrics( tess, out, *nindices / 2, f );
 
 		vertCount = 0;
 		start = edge = f->anEdge;
 		do
 		{
-			for (int i=0;i<MAX_DIMENSIONS && i<vertexSize ;i++) {
-				*verts++ = edge->Org->coords[i];
-			}
-			*vertInds++ = edge->Org->idx;
+			if ( *nverts == out->vertexCapacity )
+				return 0;
+			if ( out->edgeContours != NULL )
+				out->edgeContours[*nverts] = edge->contour;
+			StoreVertex( tess, out, (*nverts)++, edge->Org, vertexSize );
 			++vertCount;
 			edge = edge->Lnext;
 		}
 		while ( edge != start );
 
-		elements[0] = startVert;
-		elements[1] = vertCount;
-		elements += 2;
+		StoreIndex( out, (*nindices)++, startVert );
+		StoreIndex( out, (*nindices)++, vertCount );
 
 		startVert += vertCount;
 	}
+	return 1;
 }
 
-void tessAddContour( TESStesselator *tess, int size, const void* vertices,
-					int stride, int numVertices )
+/* Returns 1 if the output was written to the caller's buffers. */
+static int OutputContours( TESStesselator *tess, TESSmesh *mesh, int vertexSize, TESSoutputLayout *layout )
 {
-	const unsigned char *src = (const unsigned char*)vertices;
+	TESSface *f = 0;
+	TESShalfEdge *edge = 0;
+	TESShalfEdge *start = 0;
+	int nverts = 0;
+	int nindices = 0;
+	int rc;
+	OutputTarget out;
+
+	/* Only boundary edges are left, each with one inside face, so there is
+	* one contour vertex per edge.  The contours are counted first only when
+	* they do not fit the caller's layout.
+	*/
+	rc = SelectBoundedOutputTarget( tess, layout, &out, vertexSize, mesh->edgeCount,
+									mesh->faceCount, mesh->faceCount * 2 );
+	if ( rc && !SelectElementDataTarget( tess, &out, tess->vertexBase, tess->vertexCount ) )
+		rc = 0;
+	if ( rc && !StoreContours( tess, mesh, &out, vertexSize, &nverts, &nindices ) )
+	{
+		tess->vertexCount = 0;
+		tess->elementCount = 0;
+
+		for ( f = mesh->fHead.next; f != &mesh->fHead; f = f->next )
+		{
+			if ( !f->inside ) continue;
+
+			start = edge = f->anEdge;
+			do
+			{
+				++tess->vertexCount;
+				edge = edge->Lnext;
+			}
+			while ( edge != start );
+
+			++tess->elementCount;
+		}
+
+		rc = SelectOutputTarget( tess, layout, &out, vertexSize, tess->elementCount * 2, 0 );
+		if ( rc && !SelectElementDataTarget( tess, &out, tess->vertexBase, tess->vertexCount ) )
+			rc = 0;
+		out.vertexCapacity = tess->vertexCount;
+		out.indexCapacity = tess->elementCount * 2;
+		nverts = 0;
+		nindices = 0;
+		if ( rc )
+			StoreContours( tess, mesh, &out, vertexSize, &nverts, &nindices );
+	}
+	if ( rc == 0 )
+	{
+		tess->outOfMemory = 1;
+		return 0;
+	}
+
+	SetOutputCounts( tess, layout, nverts, nindices / 2, nindices );
+	return out.inLayout;
+}
+
+/* Stores the edges of the faces which TESS_POLYGONS would output, those
+* with n != TESS_UNDEF.  Returns 0 if out runs out of room.
+*/
+static int StoreEdges( TESStesselator *tess, TESSmesh *mesh, const OutputTarget *out, int vertexSize,
+					   int *vertexCount, int *edgeCount, int *nindices )
+{
+	TESSvertex *v;
+	TESShalfEdge *e, *edge;
+
+	for ( v = mesh->vHead.next; v != &mesh->vHead; v = v->next )
+		v->n = TESS_UNDEF;
+
+	for ( e = mesh->eHead.next; e != &mesh->eHead; e = e->next )
+	{
+		if ( e->Lface->n == TESS_UNDEF && e->Rface->n == TESS_UNDEF ) continue;
+		if ( *nindices + 3 > out->indexCapacity )
+			return 0;
+
+		// Boundary edges are turned to have the polygons on their left.
+		edge = e->Lface->n != TESS_UNDEF ? e : e->Sym;
+		if ( edge->Org->n == TESS_UNDEF )
+		{
+			if ( *vertexCount == out->vertexCapacity )
+				return 0;
+			edge->Org->n = *vertexCount;
+			StoreVertex( tess, out, (*vertexCount)++, edge->Org, vertexSize );
+		}
+		if ( edge->Dst->n == TESS_UNDEF )
+		{
+			if ( *vertexCount == out->vertexCapacity )
+				return 0;
+			edge->Dst->n = *vertexCount;
+			StoreVertex( tess, out, (*vertexCount)++, edge->Dst, vertexSize );
+		}
+
+		StoreIndex( out, (*nindices)++, edge->Org->n );
+		StoreIndex( out, (*nindices)++, edge->Dst->n );
+		StoreElement( out, (*nindices)++, edge->Rface->n == TESS_UNDEF );
+		++*edgeCount;
+	}
+	return 1;
+}
+
+/* Returns 1 if the output was written to the caller's buffers. */
+static int OutputEdges( TESStesselator *tess, TESSmesh *mesh, int polySize, int vertexSize,
+						TESSoutputLayout *layout )
+{
+	TESSvertex *v;
+	TESSface *f;
 	TESShalfEdge *e;
+	int vertexCount = 0;
+	int edgeCount = 0;
+	int nindices = 0;
+	int rc;
+	OutputTarget out;
+
+	if ( polySize > 3 && !tessMeshMergeConvexFaces( mesh, polySize ) )
+	{
+		tess->outOfMemory = 1;
+		return 0;
+	}
+
+	// Faces which TESS_POLYGONS would output get n != TESS_UNDEF.
+	for ( f = mesh->fHead.next; f != &mesh->fHead; f = f->next )
+		f->n = IsOutputFace( tess, f ) ? 0 : TESS_UNDEF;
+
+	/* Each edge pair is listed once in eHead, so the mesh counts bound the
+	* output.  The edges are counted first only when they do not fit the
+	* caller's layout.
+	*/
+	rc = SelectBoundedOutputTarget( tess, layout, &out, vertexSize, mesh->vertexCount,
+									mesh->edgeCount, mesh->edgeCount * 3 );
+	if ( rc && !StoreEdges( tess, mesh, &out, vertexSize, &vertexCount, &edgeCount, &nindices ) )
+	{
+		for ( v = mesh->vHead.next; v != &mesh->vHead; v = v->next )
+			v->n = TESS_UNDEF;
+		vertexCount = 0;
+		edgeCount = 0;
+		for ( e = mesh->eHead.next; e != &mesh->eHead; e = e->next )
+		{
+			if ( e->Lface->n == TESS_UNDEF && e->Rface->n == TESS_UNDEF ) continue;
+			if ( e->Org->n == TESS_UNDEF ) { e->Org->n = 0; ++vertexCount; }
+			if ( e->Dst->n == TESS_UNDEF ) { e->Dst->n = 0; ++vertexCount; }
+			++edgeCount;
+		}
+
+		tess->vertexCount = vertexCount;
+		tess->elementCount = edgeCount;
+		rc = SelectOutputTarget( tess, layout, &out, vertexSize, edgeCount * 3, 0 );
+		out.vertexCapacity = vertexCount;
+		out.indexCapacity = edgeCount * 3;
+		vertexCount = 0;
+		edgeCount = 0;
+		nindices = 0;
+		if ( rc )
+			StoreEdges( tess, mesh, &out, vertexSize, &vertexCount, &edgeCount, &nindices );
+	}
+	if ( rc == 0 )
+	{
+		tess->outOfMemory = 1;
+		return 0;
+	}
+
+	SetOutputCounts( tess, layout, vertexCount, edgeCount, nindices );
+	return out.inLayout;
+}
+
+/* Numbers mesh vertex v on its first use, storing it unless out is NULL. */
+static TESSindex TrapezoidVertex( TESStesselator *tess, const OutputTarget *out, TESSvertex *v,
+								  int *vertexCount, int vertexSize )
+{
+	if ( v->n == TESS_UNDEF )
+	{
+		v->n = (*vertexCount)++;
+		if ( out != NULL )
+			StoreVertex( tess, out, v->n, v, vertexSize );
+	}
+	return v->n;
+}
+
+/* Returns the output vertex where edge e crosses the sweep line through
+* vertex v, which is within the s range of e: one of its ends, or a new
+* vertex interpolated between them.  The position along the sweep is taken
+* from the coordinates of v, so that the parallel sides of the trapezoids
+* are exact in the output where the sweep follows a coordinate axis.
+*/
+static TESSindex TrapezoidCorner( TESStesselator *tess, const OutputTarget *out, TESShalfEdge *e,
+								  TESSvertex *v, int *vertexCount, int vertexSize )
+{
+	TESSreal a[MAX_DIMENSIONS], b[MAX_DIMENSIONS], c[MAX_DIMENSIONS];
+	TESSreal sa, sb, w;
 	int i;
 
-	if ( tess->mesh == NULL )
-	  	tess->mesh = tessMeshNewMesh( &tess->alloc );
- 	if ( tess->mesh == NULL ) {
+	if ( e->Org->s == v->s )
+		return TrapezoidVertex( tess, out, e->Org, vertexCount, vertexSize );
+	if ( e->Dst->s == v->s )
+		return TrapezoidVertex( tess, out, e->Dst, vertexCount, vertexSize );
+
+	if ( out != NULL )
+	{
+		CopyVertexData( tess, e->Org, a, MAX_DIMENSIONS );
+		CopyVertexData( tess, e->Dst, b, MAX_DIMENSIONS );
+		CopyVertexData( tess, v, c, MAX_DIMENSIONS );
+		sa = Dot( a, tess->sUnit );
+		sb = Dot( b, tess->sUnit );
+		w = sb != sa ? (Dot( c, tess->sUnit ) - sa) / (sb - sa) : 0;
+		for ( i = 0; i < MAX_DIMENSIONS; ++i )
+			a[i] += w * (b[i] - a[i]);
+		for ( i = 0; i < 3; ++i )
+		{
+			if ( tess->sUnit[i] == 1 )
+				a[i] = c[i];
+		}
+		StoreCoords( out, *vertexCount, a, TESS_UNDEF, vertexSize );
+	}
+	return (*vertexCount)++;
+}
+
+/* Cuts the monotone face f at the sweep coordinate of each of its vertices,
+* and stores the trapezoids in between.  The lower chain of f runs from its
+* leftmost to its rightmost vertex along Lnext, the upper chain along Lprev,
+* as in tessMeshTessellateMonoRegion().  With out NULL the vertices and
+* indices are only counted.  Returns the next index position.
+*/
+static int StoreTrapezoids( TESStesselator *tess, const OutputTarget *out, int nindices, TESSface *f,
+							int *vertexCount, int vertexSize )
+{
+	TESShalfEdge *lo, *up;
+	TESSvertex *v;
+	TESSindex loLeft, upLeft, loRight, upRight;
+	TESSreal s;
+
+	lo = f->anEdge;
+	for( ; VertLeq( lo->Org, lo->Dst ); lo = lo->Lprev )
+		;
+	for( ; VertLeq( lo->Dst, lo->Org ); lo = lo->Lnext )
+		;
+	up = lo->Lprev;
+
+	loLeft = upLeft = TrapezoidVertex( tess, out, lo->Org, vertexCount, vertexSize );
+	s = lo->Org->s;
+	while (1)
+	{
+		v = VertLeq( lo->Dst, up->Org ) ? lo->Dst : up->Org;
+
+		// Vertices at the same s as the previous one only move the corners.
+		if ( v->s > s )
+		{
+			s = v->s;
+			loRight = TrapezoidCorner( tess, out, lo, v, vertexCount, vertexSize );
+			upRight = TrapezoidCorner( tess, out, up, v, vertexCount, vertexSize );
+			if ( out != NULL )
+			{
+				StoreIndex( out, nindices, loLeft );
+				StoreIndex( out, nindices + 1, loRight );
+				StoreIndex( out, nindices + 2, upRight );
+				StoreIndex( out, nindices + 3, upLeft );
+			}
+			nindices += 4;
+			loLeft = loRight;
+			upLeft = upRight;
+		}
+
+		if ( lo->Dst == up->Org )
+			break;
+		if ( v == lo->Dst )
+		{
+			lo = lo->Lnext;
+			loLeft = TrapezoidVertex( tess, out, lo->Org, vertexCount, vertexSize );
+		}
+		else
+		{
+			up = up->Lprev;
+			upLeft = TrapezoidVertex( tess, out, up->Dst, vertexCount, vertexSize );
+		}
+	}
+	return nindices;
+}
+
+/* Returns 1 if the output was written to the caller's buffers. */
+static int OutputTrapezoids( TESStesselator *tess, TESSmesh *mesh, int vertexSize, TESSoutputLayout *layout )
+{
+	TESSvertex *v;
+	TESSface *f;
+	int vertexCount = 0;
+	int nindices = 0;
+	OutputTarget out;
+
+	// Measure, then cut the faces again for real.
+	for ( v = mesh->vHead.next; v != &mesh->vHead; v = v->next )
+		v->n = TESS_UNDEF;
+	for ( f = mesh->fHead.next; f != &mesh->fHead; f = f->next )
+	{
+		if ( IsOutputFace( tess, f ) )
+			nindices = StoreTrapezoids( tess, NULL, nindices, f, &vertexCount, vertexSize );
+	}
+
+	tess->vertexCount = vertexCount;
+	tess->elementCount = nindices / 4;
+	if ( !SelectOutputTarget( tess, layout, &out, vertexSize, nindices, 0 ) )
+	{
 		tess->outOfMemory = 1;
-		return;
+		return 0;
+	}
+
+	for ( v = mesh->vHead.next; v != &mesh->vHead; v = v->next )
+		v->n = TESS_UNDEF;
+	vertexCount = 0;
+	nindices = 0;
+	for ( f = mesh->fHead.next; f != &mesh->fHead; f = f->next )
+	{
+		if ( IsOutputFace( tess, f ) )
+			nindices = StoreTrapezoids( tess, &out, nindices, f, &vertexCount, vertexSize );
+	}
+
+	return out.inLayout;
+}
+
+/* Variant of tessMeshTessellateInterior() for TESS_POLYGONS with a
+* triangle callback: each monotone region is triangulated, its triangles
+* are passed to the callback, and then they are zapped, which returns their
+* faces, and the edges and vertices no other face uses, to the bucket
+* allocators.  This runs after the sweep, so the swept mesh is still held
+* as a whole; only the output arrays and the diagonals of all but one
+* region are saved.  Returns 0 if out of memory.
+*/
+static int EmitTriangles( TESStesselator *tess, TESSmesh *mesh, int vertexSize )
+{
+	TESSreal coords[3 * MAX_DIMENSIONS];
+	TESSindex indices[3];
+	TESSface *f, *next, *prev, *tri, *triNext;
+	TESShalfEdge *edge;
+	int i;
+
+	for( f = mesh->fHead.next; f != &mesh->fHead; f = next ) {
+		next = f->next;
+		if( !f->inside ) continue;
+
+		/* The new triangles are linked in between prev and f. */
+		prev = f->prev;
+		if ( !tessMeshTessellateMonoRegion( mesh, f ) ) return 0;
+
+		for( tri = prev->next; tri != next; tri = triNext ) {
+			triNext = tri->next;
+			if ( IsOutputFace( tess, tri ) ) {
+				edge = tri->anEdge;
+				assert( edge->Lnext->Lnext->Lnext == edge );
+				for ( i = 0; i < 3; ++i ) {
+					CopyVertexData( tess, edge->Org, &coords[i * vertexSize], vertexSize );
+					indices[i] = edge->Org->idx;
+					edge = edge->Lnext;
+				}
+				tess->triangleCallback( tess->triangleUserData, coords, indices, vertexSize );
+			}
+			tessMeshZapFace( mesh, tri );
+		}
+	}
+
+	return 1;
+}
+
+/* Triangle strips and fans are built greedily over the interior faces,
+* as in the GLU renderer: starting from each face which is not yet used,
+* the longest strip (or fan) through it is measured from each of its three
+* edges and the best one is emitted.  Faces are "marked" once used; the
+* faces tentatively claimed while measuring are kept on a trail so that
+* they can be released again.
+*/
+#define Marked(f)	((f)->marked)
+#define AddToTrail(f,t)	((f)->trail = (t), (t) = (f), (f)->marked = TRUE)
+#define FreeTrail(t)	do { while( (t) != NULL ) { (t)->marked = FALSE; (t) = (t)->trail; } } while(0)
+#define IsEven(n)	(((n) & 1) == 0)
+
+typedef int (*RenderFunc)( const OutputTarget *out, int n, TESShalfEdge *e, int size );
+
+struct FaceCount {
+	int size;				/* number of triangles used */
+	TESShalfEdge *eStart;	/* edge where this primitive starts */
+	RenderFunc render;
+};
+
+/* Stores an index unless only counting (out == NULL).  Returns the next position. */
+static int EmitIndex( const OutputTarget *out, int n, TESSindex value )
+{
+	if ( out != NULL )
+		StoreIndex( out, n, value );
+	return n + 1;
+}
+
+static int RenderTriangle( const OutputTarget *out, int n, TESShalfEdge *e, int size )
+{
+	/* Just add the triangle as a primitive of its own. */
+	assert( size == 1 );
+	(void)size;
+	e->Lface->marked = TRUE;
+	n = EmitIndex( out, n, e->Org->n );
+	n = EmitIndex( out, n, e->Dst->n );
+	n = EmitIndex( out, n, e->Lnext->Dst->n );
+	return EmitIndex( out, n, TESS_UNDEF );
+}
+
+static int RenderFan( const OutputTarget *out, int n, TESShalfEdge *e, int size )
+{
+	/* Render as many CCW triangles as possible in a fan starting from
+	* edge "e".  The fan *should* contain exactly "size" triangles.
+	*/
+	n = EmitIndex( out, n, e->Org->n );
+	n = EmitIndex( out, n, e->Dst->n );
+
+	while( ! Marked( e->Lface )) {
+		e->Lface->marked = TRUE;
+		--size;
+		e = e->Onext;
+		n = EmitIndex( out, n, e->Dst->n );
+	}
+
+	assert( size == 0 );
+	return EmitIndex( out, n, TESS_UNDEF );
+}
+
+static int RenderStrip( const OutputTarget *out, int n, TESShalfEdge *e, int size )
+{
+	/* Render as many CCW triangles as possible in a strip starting from
+	* edge "e".  The strip *should* contain exactly "size" triangles.
+	*/
+	n = EmitIndex( out, n, e->Org->n );
+	n = EmitIndex( out, n, e->Dst->n );
+
+	while( ! Marked( e->Lface )) {
+		e->Lface->marked = TRUE;
+		--size;
+		e = e->Dprev;
+		n = EmitIndex( out, n, e->Org->n );
+		if( Marked( e->Lface )) break;
+
+		e->Lface->marked = TRUE;
+		--size;
+		e = e->Onext;
+		n = EmitIndex( out, n, e->Dst->n );
+	}
+
+	assert( size == 0 );
+	return EmitIndex( out, n, TESS_UNDEF );
+}
+
+static struct FaceCount MaximumFan( TESShalfEdge *eOrig )
+{
+	/* eOrig->Lface is the face we want to render.  We want to find the size
+	* of a maximal fan around eOrig->Org.  To do this we just walk around
+	* the origin vertex as far as possible in both directions.
+	*/
+	struct FaceCount newFace = { 0, NULL, &RenderFan };
+	TESSface *trail = NULL;
+	TESShalfEdge *e;
+
+	for( e = eOrig; ! Marked( e->Lface ); e = e->Onext ) {
+		AddToTrail( e->Lface, trail );
+		++newFace.size;
+	}
+	for( e = eOrig; ! Marked( e->Rface ); e = e->Oprev ) {
+		AddToTrail( e->Rface, trail );
+		++newFace.size;
+	}
+	newFace.eStart = e;
+	FreeTrail( trail );
+	return newFace;
+}
+
+static struct FaceCount MaximumStrip( TESShalfEdge *eOrig )
+{
+	/* Here we are looking for a maximal strip that contains the vertices
+	* eOrig->Org, eOrig->Dst, eOrig->Lnext->Dst (in that order or the
+	* reverse, such that all triangles are oriented CCW).
+	*
+	* Again we walk forward and backward as far as possible.  However for
+	* strips there is a twist: to get CCW orientations, there must be
+	* an *even* number of triangles in the strip on one side of eOrig.
+	* We walk the strip starting on a side with an even number of triangles;
+	* if both side have an odd number, we are forced to shorten one side.
+	*/
+	struct FaceCount newFace = { 0, NULL, &RenderStrip };
+	int headSize = 0, tailSize = 0;
+	TESSface *trail = NULL;
+	TESShalfEdge *e, *eTail, *eHead;
+
+	for( e = eOrig; ! Marked( e->Lface ); ++tailSize, e = e->Onext ) {
+		AddToTrail( e->Lface, trail );
+		++tailSize;
+		e = e->Dprev;
+		if( Marked( e->Lface )) break;
+		AddToTrail( e->Lface, trail );
+	}
+	eTail = e;
+
+	for( e = eOrig; ! Marked( e->Rface ); ++headSize, e = e->Dnext ) {
+		AddToTrail( e->Rface, trail );
+		++headSize;
+		e = e->Oprev;
+		if( Marked( e->Rface )) break;
+		AddToTrail( e->Rface, trail );
+	}
+	eHead = e;
+
+	newFace.size = tailSize + headSize;
+	if( IsEven( tailSize )) {
+		newFace.eStart = eTail->Sym;
+	} else if( IsEven( headSize )) {
+		newFace.eStart = eHead;
+	} else {
+		/* Both sides have odd length, we must shorten one of them.  In fact,
+		* we must start from eHead to guarantee inclusion of eOrig->Lface.
+		*/
+		--newFace.size;
+		newFace.eStart = eHead->Onext;
+	}
+	FreeTrail( trail );
+	return newFace;
+}
+
+/* Covers every unmarked face with strips or fans.  Returns the number of
+* indices, and the number of primitives in *count.  With out == NULL the
+* indices are only counted.
+*/
+static int RenderFaceGroups( const OutputTarget *out, TESSmesh *mesh, int elementType, int *count )
+{
+	TESSface *f;
+	TESShalfEdge *e;
+	struct FaceCount max, newFace;
+	int n = 0;
+
+	*count = 0;
+	for( f = mesh->fHead.next; f != &mesh->fHead; f = f->next ) {
+		if( Marked( f )) continue;
+
+		/* The triangle on its own is the fallback; look for something longer. */
+		e = f->anEdge;
+		max.size = 1;
+		max.eStart = e;
+		max.render = &RenderTriangle;
+
+		if( elementType == TESS_TRIANGLE_FANS ) {
+			newFace = MaximumFan( e ); if( newFace.size > max.size ) { max = newFace; }
+			newFace = MaximumFan( e->Lnext ); if( newFace.size > max.size ) { max = newFace; }
+			newFace = MaximumFan( e->Lprev ); if( newFace.size > max.size ) { max = newFace; }
+		} else {
+			newFace = MaximumStrip( e ); if( newFace.size > max.size ) { max = newFace; }
+			newFace = MaximumStrip( e->Lnext ); if( newFace.size > max.size ) { max = newFace; }
+			newFace = MaximumStrip( e->Lprev ); if( newFace.size > max.size ) { max = newFace; }
+		}
+
+		n = (*max.render)( out, n, max.eStart, max.size );
+		++*count;
+	}
+	return n;
+}
+
+/* Outputs the interior as triangle strips or fans, each followed by TESS_UNDEF.
+* Returns 1 if the output was written to the caller's buffers.
+*/
+static int OutputFaceGroups( TESStesselator *tess, TESSmesh *mesh, int elementType, int vertexSize,
+							 TESSoutputLayout *layout )
+{
+	TESSvertex *v;
+	TESSface *f;
+	TESShalfEdge *edge;
+	int vertexCount = 0;
+	int faceCount = 0;
+	int nindices;
+	OutputTarget out;
+
+	for ( v = mesh->vHead.next; v != &mesh->vHead; v = v->next )
+		v->n = TESS_UNDEF;
+
+	// Number the vertices used by the output faces; all other faces count as used.
+	for ( f = mesh->fHead.next; f != &mesh->fHead; f = f->next )
+	{
+		f->n = TESS_UNDEF;
+		f->marked = TRUE;
+		f->trail = NULL;
+		if( !f->inside ) continue;
+
+		if( tess->noEmptyPolygons )
+		{
+			TESSreal area = tessFaceArea(f);
+			if( ABS(area) < __FLT_EPSILON__ )
+				continue;
+		}
+
+		edge = f->anEdge;
+		do
+		{
+			v = edge->Org;
+			if ( v->n == TESS_UNDEF )
+				v->n = vertexCount++;
+			edge = edge->Lnext;
+		}
+		while (edge != f->anEdge);
+
+		f->n = faceCount++;
+		f->marked = FALSE;
+	}
+
+	// Measure, then build the same primitives again for real.
+	nindices = RenderFaceGroups( NULL, mesh, elementType, &tess->elementCount );
+	for ( f = mesh->fHead.next; f != &mesh->fHead; f = f->next )
+		f->marked = (f->n == TESS_UNDEF);
+
+	tess->vertexCount = vertexCount;
+	if ( !SelectOutputTarget( tess, layout, &out, vertexSize, nindices, 0 ) )
+	{
+		tess->outOfMemory = 1;
+		return 0;
+	}
+
+	for ( v = mesh->vHead.next; v != &mesh->vHead; v = v->next )
+	{
+		if ( v->n != TESS_UNDEF )
+			StoreVertex( tess, &out, v->n, v, vertexSize );
+	}
+
+	RenderFaceGroups( &out, mesh, elementType, &faceCount );
+
+	return out.inLayout;
+}
+
+/* Meshlets are grown one at a time from a seed face, across the
+* edges to neighbouring faces (as given by GetNeighbourFace() for
+* TESS_CONNECTED_POLYGONS).  The next face is the one on the frontier
+* which adds the fewest new vertices, closest to the centre of the
+* meshlet so far.  A meshlet is closed when no face fits in its limits
+* any more; the next one is seeded from its frontier, so that consecutive
+* meshlets stay next to each other.  Faces are "marked" once used.
+*/
+struct MeshletBuilder {
+	TESSface **front;		/* faces next to the current meshlet, may repeat */
+	int nfront;
+	TESSindex *local;		/* local index of each vertex (by v->n) ... */
+	int *stamp;				/* ... valid if stamp equals the meshlet number */
+	TESSreal center[3];		/* sum of the meshlet's vertex positions */
+};
+
+static int NewVertexCount( struct MeshletBuilder *mb, TESSface *f, int meshlet )
+{
+	TESShalfEdge *edge = f->anEdge;
+	int n = 0;
+
+	do
+	{
+		if ( mb->stamp[edge->Org->n] != meshlet )
+			n++;
+		edge = edge->Lnext;
+	}
+	while (edge != f->anEdge);
+	return n;
+}
+
+static void AddMeshletFace( TESStesselator *tess, struct MeshletBuilder *mb, TESSmeshlet *m,
+						   TESSface *f, int meshlet, int *nverts )
+{
+	TESShalfEdge *edge = f->anEdge;
+	TESSvertex *v;
+	TESSreal coords[3];
+	unsigned char *tri = &tess->meshletTriangles[(m->triangleOffset + m->triangleCount) * 3];
+	int i;
+
+	f->marked = TRUE;
+	do
+	{
+		v = edge->Org;
+		if ( mb->stamp[v->n] != meshlet )
+		{
+			mb->stamp[v->n] = meshlet;
+			mb->local[v->n] = m->vertexCount++;
+			tess->meshletVertices[(*nverts)++] = v->n;
+			CopyVertexData( tess, v, coords, 3 );
+			for ( i = 0; i < 3; ++i )
+			{
+				if ( coords[i] < m->bmin[i] ) m->bmin[i] = coords[i];
+				if ( coords[i] > m->bmax[i] ) m->bmax[i] = coords[i];
+				mb->center[i] += coords[i];
+			}
+		}
+		*tri++ = (unsigned char)mb->local[v->n];
+
+		if ( edge->Rface != NULL && !edge->Rface->marked )
+			mb->front[mb->nfront++] = edge->Rface;
+		edge = edge->Lnext;
+	}
+	while (edge != f->anEdge);
+	m->triangleCount++;
+}
+
+/* Returns the best face on the frontier to add to meshlet m, or NULL. */
+static TESSface *NextMeshletFace( TESStesselator *tess, struct MeshletBuilder *mb, TESSmeshlet *m, int meshlet )
+{
+	TESSface *f, *best = NULL;
+	TESShalfEdge *edge;
+	TESSreal center[3], sum[3], coords[3], dist, bestDist = 0;
+	int i, j, k, n, count, bestNew = 0;
+
+	for ( k = 0; k < 3; ++k )
+		center[k] = mb->center[k] / m->vertexCount;
+
+	for ( i = 0, j = 0; i < mb->nfront; ++i )
+	{
+		f = mb->front[i];
+		if ( f->marked ) continue;
+		mb->front[j++] = f;
+
+		n = NewVertexCount( mb, f, meshlet );
+		if ( m->vertexCount + n > tess->meshletMaxVertices )
+			continue;
+		if ( best != NULL && n > bestNew )
+			continue;
+
+		// Distance of the face centroid from the centre of the meshlet.
+		sum[0] = sum[1] = sum[2] = 0;
+		count = 0;
+		edge = f->anEdge;
+		do
+		{
+			CopyVertexData( tess, edge->Org, coords, 3 );
+			for ( k = 0; k < 3; ++k )
+				sum[k] += coords[k];
+			count++;
+			edge = edge->Lnext;
+		}
+		while (edge != f->anEdge);
+		dist = 0;
+		for ( k = 0; k < 3; ++k )
+			dist += (sum[k] / count - center[k]) * (sum[k] / count - center[k]);
+
+		if ( best == NULL || n < bestNew || dist < bestDist )
+		{
+			best = f;
+			bestNew = n;
+			bestDist = dist;
+		}
+	}
+	mb->nfront = j;
+	return best;
+}
+
+/* Outputs the triangles grouped into meshlets, see TESS_MESHLETS.
+* Returns 1 if the output was written to the caller's buffers.
+*/
+static int OutputMeshlets( TESStesselator *tess, TESSmesh *mesh, int vertexSize, TESSoutputLayout *layout )
+{
+	struct MeshletBuilder mb;
+	TESSmeshlet *m;
+	TESSvertex *v;
+	TESSface *f, *seed, *cursor;
+	TESShalfEdge *edge;
+	TESSindex *remap;
+	int faceCount = 0, vertexCount = 0;
+	int nverts = 0, nindices = 0;
+	int i, j;
+	size_t size;
+	void *p;
+	OutputTarget out;
+
+	for ( v = mesh->vHead.next; v != &mesh->vHead; v = v->next )
+		v->n = TESS_UNDEF;
+
+	// Number the output vertices; all faces which are not output count as used.
+	for ( f = mesh->fHead.next; f != &mesh->fHead; f = f->next )
+	{
+		f->marked = TRUE;
+		if( !f->inside ) continue;
+
+		if( tess->noEmptyPolygons )
+		{
+			TESSreal area = tessFaceArea(f);
+			if( ABS(area) < __FLT_EPSILON__ )
+				continue;
+		}
+
+		edge = f->anEdge;
+		do
+		{
+			v = edge->Org;
+			if ( v->n == TESS_UNDEF )
+				v->n = vertexCount++;
+			edge = edge->Lnext;
+		}
+		while (edge != f->anEdge);
+
+		f->marked = FALSE;
+		faceCount++;
+	}
+
+	// Every meshlet has at least one face, and every face adds at most 3 vertices.
+	p = ReserveOutput( tess, tess->meshlets, &tess->meshletsMax, faceCount, sizeof(TESSmeshlet) );
+	if ( !p )
+	{
+		tess->outOfMemory = 1;
+		return 0;
+	}
+	tess->meshlets = (TESSmeshlet *)p;
+	p = ReserveOutput( tess, tess->meshletVertices, &tess->meshletVerticesMax, faceCount * 3, sizeof(TESSindex) );
+	if ( !p )
+	{
+		tess->outOfMemory = 1;
+		return 0;
+	}
+	tess->meshletVertices = (TESSindex *)p;
+	p = ReserveOutput( tess, tess->meshletTriangles, &tess->meshletTrianglesMax, faceCount * 3, 1 );
+	if ( !p )
+	{
+		tess->outOfMemory = 1;
+		return 0;
+	}
+	tess->meshletTriangles = (unsigned char *)p;
+
+	size = sizeof(TESSface*) * (tess->meshletMaxTriangles * 3 + 3)
+		 + sizeof(TESSindex) * (size_t)vertexCount * 2 + sizeof(int) * (size_t)vertexCount;
+	if ( size > INT_MAX )
+	{
+		tess->outOfMemory = 1;
+		return 0;
+	}
+	p = ReserveOutput( tess, tess->scratch, &tess->scratchMax, (int)size, 1 );
+	if ( !p )
+	{
+		tess->outOfMemory = 1;
+		return 0;
+	}
+	tess->scratch = p;
+	mb.front = (TESSface **)p;
+	mb.local = (TESSindex *)&mb.front[tess->meshletMaxTriangles * 3 + 3];
+	remap = &mb.local[vertexCount];
+	mb.stamp = (int *)&remap[vertexCount];
+	for ( i = 0; i < vertexCount; ++i )
+	{
+		mb.stamp[i] = -1;
+		remap[i] = TESS_UNDEF;
+	}
+
+	mb.nfront = 0;
+	cursor = mesh->fHead.next;
+	tess->meshletCount = 0;
+	for ( ;; )
+	{
+		// Seed next to the previous meshlet if possible.
+		seed = NULL;
+		for ( i = 0; i < mb.nfront && seed == NULL; ++i )
+		{
+			if ( !mb.front[i]->marked )
+				seed = mb.front[i];
+		}
+		if ( seed == NULL )
+		{
+			while ( cursor != &mesh->fHead && cursor->marked )
+				cursor = cursor->next;
+			if ( cursor == &mesh->fHead )
+				break;
+			seed = cursor;
+		}
+
+		m = &tess->meshlets[tess->meshletCount];
+		m->vertexOffset = nverts;
+		m->vertexCount = 0;
+		m->triangleOffset = tess->meshletCount > 0 ? m[-1].triangleOffset + m[-1].triangleCount : 0;
+		m->triangleCount = 0;
+		for ( i = 0; i < 3; ++i )
+		{
+			m->bmin[i] = FLT_MAX;
+			m->bmax[i] = -FLT_MAX;
+			mb.center[i] = 0;
+		}
+		mb.nfront = 0;
+
+		for ( f = seed; f != NULL; f = NextMeshletFace( tess, &mb, m, tess->meshletCount ) )
+		{
+			AddMeshletFace( tess, &mb, m, f, tess->meshletCount, &nverts );
+			if ( m->triangleCount == tess->meshletMaxTriangles )
+				break;
+		}
+		tess->meshletCount++;
+	}
+
+	// Number the vertices in the order the meshlets first use them.
+	j = 0;
+	for ( i = 0; i < nverts; ++i )
+	{
+		TESSindex old = tess->meshletVertices[i];
+		if ( remap[old] == TESS_UNDEF )
+			remap[old] = j++;
+		tess->meshletVertices[i] = remap[old];
+	}
+	for ( v = mesh->vHead.next; v != &mesh->vHead; v = v->next )
+	{
+		if ( v->n != TESS_UNDEF )
+			v->n = remap[v->n];
+	}
+
+	tess->vertexCount = vertexCount;
+	tess->elementCount = faceCount;
+	if ( !SelectOutputTarget( tess, layout, &out, vertexSize, faceCount * 3, 0 ) )
+	{
+		tess->outOfMemory = 1;
+		return 0;
+	}
+
+	for ( v = mesh->vHead.next; v != &mesh->vHead; v = v->next )
+	{
+		if ( v->n != TESS_UNDEF )
+			StoreVertex( tess, &out, v->n, v, vertexSize );
+	}
+
+	for ( i = 0; i < tess->meshletCount; ++i )
+	{
+		m = &tess->meshlets[i];
+		for ( j = 0; j < m->triangleCount * 3; ++j )
+		{
+			unsigned char local = tess->meshletTriangles[m->triangleOffset * 3 + j];
+			StoreIndex( &out, nindices++, tess->meshletVertices[m->vertexOffset + local] );
+		}
+	}
+
+	return out.inLayout;
+}
+
+/* Makes room for 'count' more rows in the vertex data table.  The table
+* grows by allocating and copying, so memrealloc is not required.
+*/
+int tessReserveVertexData( TESStesselator *tess, int count )
+{
+	TESSreal *data;
+	int max, i, n;
+
+	if( tess->vertexDataCount + count <= tess->vertexDataMax )
+		return 1;
+
+	max = tess->vertexDataMax > 0 ? tess->vertexDataMax * 2 : 64;
+	while( max < tess->vertexDataCount + count )
+		max *= 2;
+	data = (TESSreal *)tess->alloc.memalloc( tess->alloc.userData,
+											sizeof(TESSreal) * max * tess->vertexDataSize );
+	if (data == NULL) return 0;
+
+	if( tess->vertexData != NULL ) {
+		n = tess->vertexDataCount * tess->vertexDataSize;
+		for( i = 0; i < n; ++i )
+			data[i] = tess->vertexData[i];
+		tess->alloc.memfree( tess->alloc.userData, tess->vertexData );
+	}
+	tess->vertexData = data;
+	tess->vertexDataMax = max;
+	return 1;
+}
+
+/* Widens the rows of the vertex data table to hold 'size' coordinates,
+* zero padding the rows already stored.
+*/
+static int SetVertexDataSize( TESStesselator *tess, int size )
+{
+	TESSreal *data;
+	int i, j;
+
+	if ( size < 3 )
+		size = 3;
+	if( size <= tess->vertexDataSize )
+		return 1;
+
+	if( tess->vertexData != NULL ) {
+		data = (TESSreal *)tess->alloc.memalloc( tess->alloc.userData,
+												sizeof(TESSreal) * tess->vertexDataMax * size );
+		if (data == NULL) return 0;
+		for( i = 0; i < tess->vertexDataCount; ++i ) {
+			for( j = 0; j < tess->vertexDataSize; ++j )
+				data[i*size + j] = tess->vertexData[i*tess->vertexDataSize + j];
+			for( ; j < size; ++j )
+				data[i*size + j] = 0;
+		}
+		tess->alloc.memfree( tess->alloc.userData, tess->vertexData );
+		tess->vertexData = data;
+	}
+	tess->vertexDataSize = size;
+	return 1;
+}
+
+/* Size of the stack arrays of OutputConvexContour(). */
+#define CONVEX_MAX_VERTICES	32
+
+/* Returns whether the contour of n points is strictly convex and lies in
+* a plane of constant z, which is what OutputConvexContour() can handle:
+* every turn has the same orientation, and the x and y coordinates each
+* change direction only twice, which rules out contours winding around
+* more than once.  Turns too flat for the sweep's single precision tests
+* to agree on are left to the sweep.
+*/
+static int IsConvexContour( int size, const unsigned char *src, int stride, int n )
+{
+	const TESSreal *a, *b, *c;
+	double ux, uy, vx, vy, cross;
+	int i, turn = 0, xFlips = 0, yFlips = 0, xDir = 0, yDir = 0, dir;
+
+	if ( n < 3 || n > CONVEX_MAX_VERTICES )
+		return 0;
+	for ( i = 0; i < n; ++i ) {
+		a = (const TESSreal *)(src + i*stride);
+		b = (const TESSreal *)(src + ((i+1) % n)*stride);
+		c = (const TESSreal *)(src + ((i+2) % n)*stride);
+		if ( size > 2 && a[2] != b[2] )
+			return 0;
+
+		ux = (double)b[0] - a[0];
+		uy = (double)b[1] - a[1];
+		vx = (double)c[0] - b[0];
+		vy = (double)c[1] - b[1];
+		cross = ux*vy - uy*vx;
+		if ( !(fabs(cross) > (fabs(ux*vy) + fabs(uy*vx)) * 64 * FLT_EPSILON) )
+			return 0;
+		dir = cross > 0 ? 1 : -1;
+		if ( turn != dir && turn != 0 )
+			return 0;
+		turn = dir;
+
+		dir = ux > 0 ? 1 : (ux < 0 ? -1 : 0);
+		if ( dir != 0 ) {
+			if ( dir != xDir && xDir != 0 )
+				xFlips++;
+			xDir = dir;
+		}
+		dir = uy > 0 ? 1 : (uy < 0 ? -1 : 0);
+		if ( dir != 0 ) {
+			if ( dir != yDir && yDir != 0 )
+				yFlips++;
+			yDir = dir;
+		}
+	}
+	return xFlips <= 2 && yFlips <= 2;
+}
+
+/* Adds the rows first..first+count-1 of vertexData to the mesh as a
+* contour loop.  Returns 0 if out of memory.
+*/
+static int AddContourLoop( TESStesselator *tess, int first, int count,
+						   TESSindex idx, TESSindex contour )
+{
+	TESShalfEdge *e;
+	int i;
+
+	if ( tess->mesh == NULL ) {
+		/* Reuse the storage of the previous tessellation if there is one. */
+		if ( tess->spareMesh != NULL ) {
+			tess->mesh = tess->spareMesh;
+			tess->spareMesh = NULL;
+		} else {
+			tess->mesh = tessMeshNewMesh( &tess->alloc );
+		}
+	}
+	if ( tess->mesh == NULL )
+		return 0;
+
+	e = NULL;
+
+	for( i = 0; i < count; ++i )
+	{
+		if( e == NULL ) {
+			/* Make a self-loop (one vertex, one edge). */
+			e = tessMeshMakeEdge( tess->mesh );
+			if ( e == NULL )
+				return 0;
+			if ( !tessMeshSplice( tess->mesh, e, e->Sym ) )
+				return 0;
+		} else {
+			/* Create a new vertex and edge which immediately follow e
+			* in the ordering around the left face.
+			*/
+			if ( tessMeshSplitEdge( tess->mesh, e ) == NULL )
+				return 0;
+			e = e->Lnext;
+		}
+
+		e->Org->data = first + i;
+
+		/* Store the insertion number so that the vertex can be later recognized. */
+		e->Org->idx = idx + i;
+
+		/* The winding of an edge says how the winding number changes as we
+		* cross from the edge's right face to its left face.  We add the
+		* vertices in such an order that a CCW contour will add +1 to
+		* the winding number of the region inside the contour.
+		*/
+		e->winding = 1;
+		e->Sym->winding = -1;
+		e->contour = contour;
+		e->Sym->contour = contour;
+	}
+	return 1;
+}
+
+/* Moves the convex contour held back by tessAddContour(), if any, into
+* the mesh.  Returns 0 if out of memory.
+*/
+static int AddConvexContour( TESStesselator *tess )
+{
+	int count = tess->convexCount;
+
+	tess->convexCount = 0;
+	if ( count == 0 )
+		return 1;
+	return AddContourLoop( tess, tess->convexFirst, count, tess->convexIndex, tess->convexContour );
+}
+
+/* Copies the contour into the vertex data table and adds it to the mesh.
+* A first contour which is convex is held back instead, so that a lone
+* convex polygon can be output without building the mesh.
+*/
+void tessAddContour( TESStesselator *tess, int size, const void* vertices,
+					int stride, int numVertices )
+{
+	const unsigned char *src = (const unsigned char*)vertices;
+	TESSreal *data;
+	TESSindex contour = tess->contourCounter++;
+	int first, i, j;
+
+	if ( size < 2 )
+		size = 2;
+	if ( size > MAX_DIMENSIONS )
+		size = MAX_DIMENSIONS;
+
+	if ( !SetVertexDataSize( tess, size ) || !tessReserveVertexData( tess, numVertices ) ) {
+		tess->outOfMemory = 1;
+		return;
+	}
+
+	first = tess->vertexDataCount;
+	for( i = 0; i < numVertices; ++i )
+	{
+		const TESSreal* coords = (const TESSreal*)src;
+		src += stride;
+
+		data = &tess->vertexData[(first + i) * tess->vertexDataSize];
+		for( j = 0; j < size; ++j )
+			data[j] = coords[j];
+		for( ; j < tess->vertexDataSize; ++j )
+			data[j] = 0;
+	}
+	tess->vertexDataCount += numVertices;
+
+	if ( tess->mesh == NULL && tess->convexCount == 0
+		&& IsConvexContour( size, (const unsigned char*)vertices, stride, numVertices ) ) {
+		tess->convexCount = numVertices;
+		tess->convexFirst = first;
+		tess->convexIndex = tess->vertexIndexCounter;
+		tess->convexContour = contour;
+		tess->vertexIndexCounter += numVertices;
+		return;
+	}
+
+	if ( !AddConvexContour( tess )
+		|| !AddContourLoop( tess, first, numVertices, tess->vertexIndexCounter, contour ) ) {
+		tess->outOfMemory = 1;
+		return;
+	}
+	tess->vertexIndexCounter += numVertices;
+}
+
+/* Returns whether e is an edge between two inside triangles which
+* RefineDelaunay() may flip: one added by the tesselation, rather than
+* one on an input contour.  Pieces of contours split at intersections
+* keep their contour, so they stay fixed too.
+*/
+static int IsFlippable( TESShalfEdge *e )
+{
+	return e->contour == TESS_UNDEF && e->winding == 0
+		&& e->Lface->inside && e->Rface->inside;
+}
+
+/* RefineDelaunay( tess, mesh ) flips the edges between inside triangles
+* until each is locally Delaunay (Lawson's algorithm), which makes the
+* triangulation constrained Delaunay with the input contours as the
+* constraints.  Only the edges around a flip need to be checked again.
+* In case rounding keeps nearly cocircular vertices flipping back and
+* forth, the number of flips is capped.  Returns 0 if out of memory.
+*/
+static int RefineDelaunay( TESStesselator *tess, TESSmesh *mesh )
+{
+	TESShalfEdge **stack, *e, *eHead = &mesh->eHead;
+	TESShalfEdge *around[4];
+	TESSvertex *a, *b, *c, *d;
+	int i, count, maxCount, flips, maxFlips;
+
+	if ( (size_t)mesh->edgeCount > INT_MAX / sizeof(TESShalfEdge*) - 4 )
+		return 0;
+	maxCount = mesh->edgeCount + 4;
+	stack = (TESShalfEdge **)ReserveOutput( tess, tess->scratch, &tess->scratchMax,
+										   maxCount * (int)sizeof(TESShalfEdge*), 1 );
+	if ( !stack )
+		return 0;
+	tess->scratch = stack;
+	maxCount = tess->scratchMax / (int)sizeof(TESShalfEdge*);
+
+	count = 0;
+	for ( e = eHead->next; e != eHead; e = e->next ) {
+		if ( IsFlippable( e ) )
+			stack[count++] = e;
+	}
+
+	flips = 0;
+	maxFlips = 16 * count;
+	while ( count > 0 ) {
+		e = stack[--count];
+		a = e->Org;
+		b = e->Dst;
+		c = e->Lnext->Dst;
+		d = e->Sym->Lnext->Dst;
+
+		/* Flip when d is inside the circumcircle of the left triangle, and
+		* the quadrilateral is strictly convex, so that the two new
+		* triangles have the same orientation as the old ones.
+		*/
+		if ( !VertInCircle( a, b, c, d ) || VertCCW( a, c, d ) || VertCCW( b, d, c ) )
+			continue;
+		if ( flips++ == maxFlips )
+			break;
+		tessMeshFlipEdge( e );
+
+		around[0] = e->Lnext;
+		around[1] = e->Lnext->Lnext;
+		around[2] = e->Sym->Lnext;
+		around[3] = e->Sym->Lnext->Lnext;
+		if ( count + 4 > maxCount ) {
+			stack = (TESShalfEdge **)GrowOutput( tess, tess->scratch, &tess->scratchMax,
+												count * (int)sizeof(TESShalfEdge*),
+												4 * (int)sizeof(TESShalfEdge*), 1 );
+			if ( !stack )
+				return 0;
+			tess->scratch = stack;
+			maxCount = tess->scratchMax / (int)sizeof(TESShalfEdge*);
+		}
+		for ( i = 0; i < 4; ++i ) {
+			if ( IsFlippable( around[i] ) )
+				stack[count++] = around[i];
+		}
+	}
+	return 1;
+}
+
+/* Makes the output of the previous calls, if appending, the whole output
+* again after a failed call.
+*/
+static void RestoreOutput( TESStesselator *tess )
+{
+	tess->vertexCount = tess->vertexBase;
+	tess->elementCount = tess->elementBase;
+	tess->indexCount = tess->indexBase;
+}
+
+/* Records the draw range of a call and adds its output to that of the
+* previous calls.  Returns 0 if out of memory.
+*/
+static int AddDrawRange( TESStesselator *tess )
+{
+	TESSdrawRange *r;
+
+	r = (TESSdrawRange*)GrowOutput( tess, tess->drawRanges, &tess->drawRangesMax,
+									tess->drawRangeCount, 1, sizeof(TESSdrawRange) );
+	if ( !r )
+		return 0;
+	tess->drawRanges = r;
+
+	r = &tess->drawRanges[tess->drawRangeCount++];
+	r->firstIndex = tess->indexBase;
+	r->indexCount = tess->indexCount;
+	r->baseVertex = tess->vertexBase;
+	r->vertexCount = tess->vertexCount;
+
+	tess->vertexCount += tess->vertexBase;
+	tess->elementCount += tess->elementBase;
+	tess->indexCount += tess->indexBase;
+	return 1;
+}
+
+/* Ends a call to Tesselate() once the output is written: drops the contours
+* and records the draw range.  Returns what Tesselate() does.
+*/
+static int FinishOutput( TESStesselator *tess, TESSoutputLayout *layout, int inLayout )
+{
+	tessReset( tess );
+
+	if (!tess->outOfMemory && !AddDrawRange( tess ))
+		tess->outOfMemory = 1;
+	if (tess->outOfMemory) {
+		RestoreOutput( tess );
+		return 0;
 	}
+	if (layout != NULL && !inLayout)
+		return -1;
+	return 1;
+}
 
-	if ( size < 2 )
-		size = 2;
-	if ( size > MAX_DIMENSIONS )
-		size = MAX_DIMENSIONS;
+/* Writes the TESS_POLYGONS output of triangles for the convex contour held
+* back by tessAddContour(), without building the mesh.  The projection,
+* the winding rule and the triangulation follow tessProjectPolygon(),
+* the sweep and tessMeshTessellateMonoRegion() step by step, on a copy of
+* the vertices on the stack, so that the output is the same as theirs.
+* Returns 0, having written nothing, if the contour needs the general
+* path after all.
+*/
+static int OutputConvexContour( TESStesselator *tess, int vertexSize )
+{
+	TESSvertex verts[CONVEX_MAX_VERTICES];
+	int next[CONVEX_MAX_VERTICES], prev[CONVEX_MAX_VERTICES];
+	int tris[(CONVEX_MAX_VERTICES - 2) * 3];
+	int n = tess->convexCount;
+	int ntris = 0, nverts = 0, nelems = 0, nindices = 0;
+	int i, k, u, l, m, last;
+	TESSreal area, *data;
+	TESSvertex *a, *b, *c;
+	double cross;
+	OutputTarget out;
+
+	for ( i = 0; i < n; ++i ) {
+		data = &tess->vertexData[(tess->convexFirst + i) * tess->vertexDataSize];
+		verts[i].s = data[0];
+		verts[i].t = data[1];
+		verts[i].data = tess->convexFirst + i;
+		verts[i].idx = tess->convexIndex + i;
+		verts[i].n = TESS_UNDEF;
+		next[i] = i + 1 < n ? i + 1 : 0;
+		prev[i] = i > 0 ? i - 1 : n - 1;
+	}
 
-	e = NULL;
+	/* The contour lies in a plane of constant z, so the computed normal
+	* is along z, and CheckOrientation() makes the contour CCW.
+	*/
+	area = 0;
+	for ( i = 0; i < n; ++i )
+		area += (verts[i].s - verts[next[i]].s) * (verts[i].t + verts[next[i]].t);
+	if ( !(area > 0) && !(area < 0) )
+		return 0;
 
-	for( i = 0; i < numVertices; ++i )
-	{
-		const TESSreal* coords = (const TESSreal*)src;
-		src += stride;
+	/* That sum cancels badly for contours which are small against their
+	* coordinates, and may get the orientation wrong.  The sweep then
+	* sees a CW contour; leave those to it.
+	*/
+	cross = ((double)verts[1].s - verts[0].s) * ((double)verts[2].t - verts[1].t)
+		  - ((double)verts[1].t - verts[0].t) * ((double)verts[2].s - verts[1].s);
+	if ( (cross > 0) != (area > 0) )
+		return 0;
+	if ( area < 0 ) {
+		for ( i = 0; i < n; ++i )
+			verts[i].t = -verts[i].t;
+	}
 
-		if( e == NULL ) {
-			/* Make a self-loop (one vertex, one edge). */
-			e = tessMeshMakeEdge( tess->mesh );
-			if ( e == NULL ) {
-				tess->outOfMemory = 1;
-				return;
-			}
-			if ( !tessMeshSplice( tess->mesh, e, e->Sym ) ) {
-				tess->outOfMemory = 1;
-				return;
-			}
-		} else {
-			/* Create a new vertex and edge which immediately follow e
-			* in the ordering around the left face.
-			*/
-			if ( tessMeshSplitEdge( tess->mesh, e ) == NULL ) {
-				tess->outOfMemory = 1;
-				return;
+	/* The one region inside the contour has winding number 1. */
+	if ( tessIsWindingInside( tess, 1 ) ) {
+		u = 0;
+		for( ; VertLeq( &verts[next[u]], &verts[u] ); u = prev[u] )
+			;
+		for( ; VertLeq( &verts[u], &verts[next[u]] ); u = next[u] )
+			;
+		l = prev[u];
+		last = u;
+
+		/* Each triangle cut off is (eNew->Org, eNew->Lnext->Org, ...) of the
+		* edge eNew made by tessMeshConnect(), which leaves the rest of the
+		* region starting at eNew->Sym.
+		*/
+		while( next[u] != l ) {
+			if( VertLeq( &verts[next[u]], &verts[l] )) {
+				while( next[l] != u && (VertLeq( &verts[next[next[l]]], &verts[next[l]] )
+					|| EdgeSign( &verts[l], &verts[next[l]], &verts[next[next[l]]] ) <= 0 )) {
+						m = next[l];
+						tris[ntris++] = next[m];
+						tris[ntris++] = l;
+						tris[ntris++] = m;
+						next[l] = next[m];
+						prev[next[m]] = l;
+						last = l;
+				}
+				l = prev[l];
+			} else {
+				while( next[l] != u && (VertLeq( &verts[prev[u]], &verts[u] )
+					|| EdgeSign( &verts[next[u]], &verts[u], &verts[prev[u]] ) >= 0 )) {
+						m = prev[u];
+						tris[ntris++] = next[u];
+						tris[ntris++] = m;
+						tris[ntris++] = u;
+						next[m] = next[u];
+						prev[next[u]] = m;
+						u = m;
+						last = u;
+				}
+				u = next[u];
 			}
-			e = e->Lnext;
 		}
-        
-        e->Org->coords[0] = coords[0];
-        e->Org->coords[1] = coords[1];
-        int j = 2;
-		for(; j<MAX_DIMENSIONS && j<size;j++) {
-				e->Org->coords[j] = coords[j];
+		while( next[next[l]] != u ) {
+			m = next[l];
+			tris[ntris++] = next[m];
+			tris[ntris++] = l;
+			tris[ntris++] = m;
+			next[l] = next[m];
+			prev[next[m]] = l;
+			last = l;
 		}
-		for(; j<MAX_DIMENSIONS;j++) {
-				e->Org->coords[j] = 0;
-		}
-        
-		/* Store the insertion number so that the vertex can be later recognized. */
-		e->Org->idx = tess->vertexIndexCounter++;
 
-		/* The winding of an edge says how the winding number changes as we
-		* cross from the edge''s right face to its left face.  We add the
-		* vertices in such an order that a CCW contour will add +1 to
-		* the winding number of the region inside the contour.
-		*/
-		e->winding = 1;
-		e->Sym->winding = -1;
+		/* What is left is the region's own face, after the new ones. */
+		tris[ntris++] = last;
+		tris[ntris++] = next[last];
+		tris[ntris++] = next[next[last]];
 	}
+
+	if ( SelectBoundedOutputTarget( tess, NULL, &out, vertexSize, n, n - 2, (n - 2) * 3 ) == 0 ) {
+		tess->outOfMemory = 1;
+		return 1;
+	}
+	for ( k = 0; k < ntris; k += 3 ) {
+		a = &verts[tris[k]];
+		b = &verts[tris[k+1]];
+		c = &verts[tris[k+2]];
+		if ( tess->noEmptyPolygons ) {
+			/* As tessFaceArea() from the face's anEdge. */
+			area = (a->s - b->s) * (a->t + b->t);
+			area += (b->s - c->s) * (b->t + c->t);
+			area += (c->s - a->s) * (c->t + a->t);
+			if ( ABS(area) < __FLT_EPSILON__ )
+				continue;
+		}
+		for ( i = 0; i < 3; ++i ) {
+			a = &verts[tris[k+i]];
+			if ( a->n == TESS_UNDEF ) {
+				a->n = nverts;
+				StoreVertex( tess, &out, nverts++, a, vertexSize );
+			}
+			StoreIndex( &out, nindices++, a->n );
+		}
+		nelems++;
+	}
+	SetOutputCounts( tess, NULL, nverts, nelems, nindices );
+	return 1;
 }
 
-int tessTesselate( TESStesselator *tess, int windingRule, int elementType,
-				  int polySize, int vertexSize, const TESSreal* normal )
+/* Returns 0 on failure, 1 when the output is in the caller's buffers or,
+* without a layout, in the internal arrays, and -1 when a layout was given
+* but the output had to go to the internal arrays.
+*/
+static int Tesselate( TESStesselator *tess, int windingRule, int elementType,
+					  int polySize, int vertexSize, const TESSreal* normal, TESSoutputLayout *layout )
 {
 	TESSmesh *mesh;
 	int rc = 1;
+	int inLayout;
 
-	if (tess->vertices != NULL) {
-		tess->alloc.memfree( tess->alloc.userData, tess->vertices );
-		tess->vertices = 0;
-	}
-	if (tess->elements != NULL) {
-		tess->alloc.memfree( tess->alloc.userData, tess->elements );
-		tess->elements = 0;
-	}
-	if (tess->vertexIndices != NULL) {
-		tess->alloc.memfree( tess->alloc.userData, tess->vertexIndices );
-		tess->vertexIndices = 0;
+	/* The output buffers are kept and overwritten, see ReserveOutput(),
+	* or appended to.  Output for caller buffers cannot be appended, and
+	* clearing the buffers for it would lose what has been appended.
+	*/
+	if ( tess->appendOutput && layout != NULL )
+		return 0;
+	if ( !tess->appendOutput ) {
+		tessClearOutput( tess );
+	} else if ( elementType != TESS_POLYGONS && elementType != TESS_TRIANGLE_STRIPS
+				&& elementType != TESS_TRIANGLE_FANS ) {
+		return 0;
 	}
+	tess->vertexBase = tess->vertexCount;
+	tess->elementBase = tess->elementCount;
+	tess->indexBase = tess->indexCount;
+	tess->vertexCount = 0;
+	tess->elementCount = 0;
+	tess->indexCount = 0;
+	tess->meshletCount = 0;
 
 	tess->vertexIndexCounter = 0;
+	tess->contourCounter = 0;
+	tess->simpleViolation = FALSE;
 	
 	if (normal)
 	{
@@ -917,13 +3073,35 @@ int tessTesselate( TESStesselator *tess, int windingRule, int elementType,
 	if (vertexSize > MAX_DIMENSIONS)
 		vertexSize = MAX_DIMENSIONS;
 
+	/* A lone convex contour is triangulated directly when the output needs
+	* nothing from the mesh beyond the triangles.
+	*/
+	if (tess->convexCount > 0) {
+		if (elementType == TESS_POLYGONS && polySize == 3 && layout == NULL
+			&& tess->triangleCallback == NULL && !tess->provenance && !tess->elementMetrics
+			&& !tess->optimizeVertexCache && !tess->delaunay
+			&& tess->normal[0] == 0 && tess->normal[1] == 0 && tess->normal[2] == 0
+			&& OutputConvexContour( tess, vertexSize ))
+			return FinishOutput( tess, layout, 1 );
+		if (!AddConvexContour( tess )) {
+			RestoreOutput( tess );
+			return 0;
+		}
+	}
+
 	if (setjmp(tess->env) != 0) { 
-		/* come back here if out of memory */
+		/* come back here if out of memory, or if contours declared simple
+		* are not; the sweep has changed the mesh, so discard them.
+		*/
+		if (tess->simpleViolation)
+			tessReset( tess );
+		RestoreOutput( tess );
 		return 0;
 	}
 
 	if (!tess->mesh)
 	{
+		RestoreOutput( tess );
 		return 0;
 	}
 
@@ -938,6 +3116,8 @@ int tessTesselate( TESStesselator *tess, int windingRule, int elementType,
 	* to the polygon, according to the rule given by tess->windingRule.
 	* Each interior region is guaranteed be monotone.
 	*/
+	tess->interpBase = tess->vertexDataCount;
+	tess->interpCount = 0;
 	if ( !tessComputeInterior( tess ) ) {
 		longjmp(tess->env,1);  /* could've used a label */
 	}
@@ -950,29 +3130,294 @@ int tessTesselate( TESStesselator *tess, int windingRule, int elementType,
 	*/
 	if (elementType == TESS_BOUNDARY_CONTOURS) {
 		rc = tessMeshSetWindingNumber( mesh, 1, TRUE );
-	} else {
+	} else if (elementType == TESS_POLYGONS && tess->triangleCallback != NULL) {
+		tessResolveVertexData( tess );
+		rc = EmitTriangles( tess, mesh, vertexSize );
+	} else if (elementType != TESS_TRAPEZOIDS) {
 		rc = tessMeshTessellateInterior( mesh ); 
+		if ( rc && tess->delaunay )
+			rc = RefineDelaunay( tess, mesh );
 	}
 	if (rc == 0) longjmp(tess->env,1);  /* could've used a label */
 
 	tessMeshCheckMesh( mesh );
 
-	if (elementType == TESS_BOUNDARY_CONTOURS) {
-		OutputContours( tess, mesh, vertexSize );     /* output contours */
+	/* The triangles given to the callback already had their data resolved. */
+	if (elementType != TESS_POLYGONS || tess->triangleCallback == NULL)
+		tessResolveVertexData( tess );
+
+	if (elementType == TESS_POLYGONS && tess->triangleCallback != NULL) {
+		OutputTarget out;     /* output went to the callback, leave it empty */
+		tess->vertexCount = 0;
+		tess->elementCount = 0;
+		if ( !SelectOutputTarget( tess, layout, &out, vertexSize, 0, 0 ) )
+			tess->outOfMemory = 1;
+		inLayout = 1;
+	}
+	else if (elementType == TESS_BOUNDARY_CONTOURS) {
+		inLayout = OutputContours( tess, mesh, vertexSize, layout );     /* output contours */
+	}
+	else if (elementType == TESS_TRIANGLE_STRIPS || elementType == TESS_TRIANGLE_FANS) {
+		inLayout = OutputFaceGroups( tess, mesh, elementType, vertexSize, layout );     /* output strips or fans */
+	}
+	else if (elementType == TESS_EDGES) {
+		inLayout = OutputEdges( tess, mesh, polySize, vertexSize, layout );     /* output edges */
+	}
+	else if (elementType == TESS_TRAPEZOIDS) {
+		inLayout = OutputTrapezoids( tess, mesh, vertexSize, layout );     /* output trapezoids */
+	}
+	else if (elementType == TESS_MESHLETS) {
+		inLayout = OutputMeshlets( tess, mesh, vertexSize, layout );     /* output meshlets */
 	}
 	else
 	{
-		OutputPolymesh( tess, mesh, elementType, polySize, vertexSize );     /* output polygons */
+		inLayout = OutputPolymesh( tess, mesh, elementType, polySize, vertexSize, layout );     /* output polygons */
 	}
 
-	tessMeshDeleteMesh( &tess->alloc, mesh );
-	tess->mesh = NULL;
+	return FinishOutput( tess, layout, inLayout );
+}
+
+int tessTesselate( TESStesselator *tess, int windingRule, int elementType,
+				  int polySize, int vertexSize, const TESSreal* normal )
+{
+	return Tesselate( tess, windingRule, elementType, polySize, vertexSize, normal, NULL ) != 0;
+}
+
+int tessTesselateInto( TESStesselator *tess, int windingRule, int elementType,
+					  int polySize, int vertexSize, const TESSreal* normal, TESSoutputLayout *layout )
+{
+	layout->vertexCount = 0;
+	layout->elementCount = 0;
+	layout->indexCount = 0;
+	if ( !LayoutValid( layout, vertexSize ) )
+		return 0;
+	return Tesselate( tess, windingRule, elementType, polySize, vertexSize, normal, layout );
+}
+
+/* An edge of the contours in pixel coordinates, see tessRasterize(). */
+typedef struct RasterEdge {
+	TESSreal x0, y0;	/* upper end, y0 < y1 */
+	TESSreal y1;
+	TESSreal dxdy;
+	TESSreal x;		/* where the current scanline crosses the edge */
+	int winding;	/* change of the winding number crossing it towards +x */
+} RasterEdge;
+
+static int RasterEdgeCompare( const void *a, const void *b )
+{
+	TESSreal y0 = ((const RasterEdge *)a)->y0;
+	TESSreal y1 = ((const RasterEdge *)b)->y0;
+	return (y0 < y1) ? -1 : (y0 > y1) ? 1 : 0;
+}
+
+/* Adds the coverage of the span [xa,xb) of one scanline to cover. */
+static void AddCoverage( TESSreal *cover, int width, TESSreal xa, TESSreal xb )
+{
+	int i, ia, ib;
+
+	if ( xa < 0 ) xa = 0;
+	if ( xb > width ) xb = (TESSreal)width;
+	if ( xb <= xa )
+		return;
+	ia = (int)xa;
+	ib = (int)xb;
+	if ( ia == ib ) {
+		cover[ia] += xb - xa;
+		return;
+	}
+	cover[ia] += (TESSreal)(ia + 1) - xa;
+	for ( i = ia + 1; i < ib; ++i )
+		cover[i] += 1;
+	if ( ib < width )
+		cover[ib] += xb - (TESSreal)ib;
+}
+
+int tessRasterize( TESStesselator *tess, int windingRule, unsigned char *mask,
+				  int width, int height, int stride, const TESSreal* viewBox, int samples )
+{
+	TESSmesh *mesh;
+	TESShalfEdge *e, *eHead;
+	TESSvertex *v, *vHead;
+	RasterEdge *edges, *r;
+	TESSreal *cover;
+	int *active;
+	TESSreal minX, minY, maxX, maxY, sx, sy, area, y, xa;
+	const TESSreal *a, *b;
+	int i, j, k, n, row, next, nactive, winding, inside, value, first;
+	size_t size;
+
+	if ( !AddConvexContour( tess ) || !tess->mesh )
+		return 0;
+	mesh = tess->mesh;
+
+	tess->vertexIndexCounter = 0;
+	tess->contourCounter = 0;
+	tess->windingRule = windingRule;
+	if ( samples < 1 )
+		samples = 1;
+
+	if ( viewBox ) {
+		minX = viewBox[0];
+		minY = viewBox[1];
+		maxX = viewBox[2];
+		maxY = viewBox[3];
+	} else {
+		minX = minY = maxX = maxY = 0;
+		first = 1;
+		vHead = &mesh->vHead;
+		for ( v = vHead->next; v != vHead; v = v->next ) {
+			a = tessVertexData( tess, v );
+			if ( first ) {
+				minX = maxX = a[0];
+				minY = maxY = a[1];
+				first = 0;
+			}
+			if ( a[0] < minX ) minX = a[0];
+			if ( a[0] > maxX ) maxX = a[0];
+			if ( a[1] < minY ) minY = a[1];
+			if ( a[1] > maxY ) maxY = a[1];
+		}
+	}
+	if ( width <= 0 || height <= 0 || maxX <= minX || maxY <= minY ) {
+		tessReset( tess );
+		return 1;
+	}
+	sx = width / (maxX - minX);
+	sy = height / (maxY - minY);
 
-	if (tess->outOfMemory)
+	/* The edges are sorted by their upper end once, and the active edges
+	* are carried from one scanline to the next: each scanline only drops
+	* the edges it has passed, and adds those it has reached.
+	*/
+	eHead = &mesh->eHead;
+	n = 0;
+	for ( e = eHead->next; e != eHead; e = e->next )
+		++n;
+	size = sizeof(RasterEdge) * n + sizeof(TESSreal) * width + sizeof(int) * n;
+	if ( size > INT_MAX ) {
+		tessReset( tess );
+		return 0;
+	}
+	edges = (RasterEdge *)ReserveOutput( tess, tess->scratch, &tess->scratchMax, (int)size, 1 );
+	if ( !edges ) {
+		tessReset( tess );
 		return 0;
+	}
+	tess->scratch = edges;
+	cover = (TESSreal *)&edges[n];
+	active = (int *)&cover[width];
+
+	/* The winding of an edge is the change of the winding number crossing
+	* it from its right face to its left face, as in ComputeWinding().  Like
+	* tessTesselate() without a normal, count it so that the contours have
+	* a non-negative total area, see CheckOrientation().
+	*/
+	n = 0;
+	area = 0;
+	for ( e = eHead->next; e != eHead; e = e->next ) {
+		if ( e->winding == 0 )
+			continue;
+		a = tessVertexData( tess, e->Org );
+		b = tessVertexData( tess, e->Dst );
+		area += e->winding * (a[0] * b[1] - b[0] * a[1]);
+		if ( a[1] == b[1] )
+			continue;
+		r = &edges[n++];
+		if ( a[1] < b[1] ) {
+			r->winding = -e->winding;
+		} else {
+			r->winding = e->winding;
+			a = b;
+			b = tessVertexData( tess, e->Org );
+		}
+		r->x0 = (a[0] - minX) * sx;
+		r->y0 = (a[1] - minY) * sy;
+		r->y1 = (b[1] - minY) * sy;
+		r->dxdy = ((b[0] - minX) * sx - r->x0) / (r->y1 - r->y0);
+	}
+	if ( area < 0 ) {
+		for ( i = 0; i < n; ++i )
+			edges[i].winding = -edges[i].winding;
+	}
+	qsort( edges, n, sizeof(RasterEdge), RasterEdgeCompare );
+
+	next = 0;
+	nactive = 0;
+	for ( row = 0; row < height; ++row, mask += stride ) {
+		/* Rows without edges, above the first or below the last, or in a
+		* gap between contours, are left as they are.
+		*/
+		if ( nactive == 0 && (next == n || edges[next].y0 >= row + 1) )
+			continue;
+
+		for ( i = 0; i < width; ++i )
+			cover[i] = 0;
+
+		for ( k = 0; k < samples; ++k ) {
+			y = row + (k + 0.5f) / samples;
+
+			/* Update the active edges, with y in [y0,y1) of each. */
+			j = 0;
+			for ( i = 0; i < nactive; ++i ) {
+				if ( edges[active[i]].y1 > y )
+					active[j++] = active[i];
+			}
+			nactive = j;
+			for ( ; next < n && edges[next].y0 <= y; ++next ) {
+				if ( edges[next].y1 > y )
+					active[nactive++] = next;
+			}
+
+			/* Keep them sorted along the scanline.  They are still in the
+			* order of the previous scanline, so only edges which crossed
+			* since, and the new ones, are moved.
+			*/
+			for ( i = 0; i < nactive; ++i ) {
+				r = &edges[active[i]];
+				r->x = r->x0 + (y - r->y0) * r->dxdy;
+				for ( j = i; j > 0 && edges[active[j-1]].x > r->x; --j )
+					active[j] = active[j-1];
+				active[j] = (int)(r - edges);
+			}
+
+			winding = 0;
+			inside = FALSE;
+			xa = 0;
+			for ( i = 0; i < nactive; ++i ) {
+				r = &edges[active[i]];
+				winding += r->winding;
+				if ( tessIsWindingInside( tess, winding ) == inside )
+					continue;
+				inside = !inside;
+				if ( inside )
+					xa = r->x;
+				else
+					AddCoverage( cover, width, xa, r->x );
+			}
+		}
+
+		for ( i = 0; i < width; ++i ) {
+			value = mask[i] + (int)(cover[i] * 255 / samples + 0.5f);
+			mask[i] = (unsigned char)(value < 255 ? value : 255);
+		}
+	}
+
+	tessReset( tess );
 	return 1;
 }
 
+void tessReset( TESStesselator *tess )
+{
+	tess->convexCount = 0;
+	/* Keep the mesh storage for the next contours instead of freeing it. */
+	if ( tess->mesh != NULL ) {
+		tessMeshResetMesh( tess->mesh );
+		tess->spareMesh = tess->mesh;
+		tess->mesh = NULL;
+	}
+	tess->vertexDataCount = 0;
+}
+
 int tessGetVertexCount( TESStesselator *tess )
 {
 	return tess->vertexCount;
@@ -998,6 +3443,231 @@ const int* tessGetElements( TESStesselator *tess )
 	return tess->elements;
 }
 
+int tessGetIndexCount( TESStesselator *tess )
+{
+	return tess->indexCount;
+}
+
+int tessGetMeshletCount( TESStesselator *tess )
+{
+	return tess->meshletCount;
+}
+
+const TESSmeshlet* tessGetMeshlets( TESStesselator *tess )
+{
+	return tess->meshlets;
+}
+
+const TESSindex* tessGetMeshletVertices( TESStesselator *tess )
+{
+	return tess->meshletVertices;
+}
+
+const unsigned char* tessGetMeshletTriangles( TESStesselator *tess )
+{
+	return tess->meshletTriangles;
+}
+
+bool tessGetProvenance( TESStesselator *_Nonnull tess )
+{
+	return tess->provenance;
+}
+
+void tessSetProvenance( TESStesselator *_Nonnull tess, bool value )
+{
+	tess->provenance = value;
+}
+
+const TESSindex* tessGetElementContours( TESStesselator *_Nonnull tess )
+{
+	return tess->elementContours;
+}
+
+const TESSindex* tessGetEdgeContours( TESStesselator *_Nonnull tess )
+{
+	return tess->edgeContours;
+}
+
+bool tessGetElementMetrics( TESStesselator *_Nonnull tess )
+{
+	return tess->elementMetrics;
+}
+
+void tessSetElementMetrics( TESStesselator *_Nonnull tess, bool value )
+{
+	tess->elementMetrics = value;
+}
+
+const TESSreal* tessGetElementMetric( TESStesselator *_Nonnull tess, int metric )
+{
+	if ( tess->metrics == NULL || metric < 0 || metric >= TESS_METRIC_COUNT )
+		return NULL;
+	return &tess->metrics[metric * tess->metricsMax];
+}
+
+bool tessGetAppendOutput( TESStesselator *_Nonnull tess )
+{
+	return tess->appendOutput;
+}
+
+void tessSetAppendOutput( TESStesselator *_Nonnull tess, bool value )
+{
+	tess->appendOutput = value;
+	tessClearOutput( tess );
+}
+
+void tessClearOutput( TESStesselator *_Nonnull tess )
+{
+	tess->vertexCount = 0;
+	tess->elementCount = 0;
+	tess->indexCount = 0;
+	tess->meshletCount = 0;
+	tess->vertexBase = 0;
+	tess->elementBase = 0;
+	tess->indexBase = 0;
+	tess->drawRangeCount = 0;
+}
+
+int tessGetDrawRangeCount( TESStesselator *_Nonnull tess )
+{
+	return tess->drawRangeCount;
+}
+
+const TESSdrawRange* tessGetDrawRanges( TESStesselator *_Nonnull tess )
+{
+	return tess->drawRanges;
+}
+
+TESSresult* tessDetachResult( TESStesselator *_Nonnull tess )
+{
+	TESSresult *result = (TESSresult *)tess->alloc.memalloc( tess->alloc.userData, sizeof(TESSresult) );
+	if ( !result )
+		return NULL;
+
+	result->vertices = tess->vertices;
+	result->vertexIndices = tess->vertexIndices;
+	result->vertexCount = tess->vertexCount;
+	result->elements = tess->elements;
+	result->elementCount = tess->elementCount;
+	result->indexCount = tess->indexCount;
+	result->meshlets = tess->meshlets;
+	result->meshletCount = tess->meshletCount;
+	result->meshletVertices = tess->meshletVertices;
+	result->meshletTriangles = tess->meshletTriangles;
+	result->elementContours = tess->elementContours;
+	result->edgeContours = tess->edgeContours;
+	result->metrics = tess->metrics;
+	result->drawRanges = tess->drawRanges;
+	result->drawRangeCount = tess->drawRangeCount;
+	result->verticesMax = tess->verticesMax;
+	result->vertexIndicesMax = tess->vertexIndicesMax;
+	result->elementsMax = tess->elementsMax;
+	result->meshletsMax = tess->meshletsMax;
+	result->meshletVerticesMax = tess->meshletVerticesMax;
+	result->meshletTrianglesMax = tess->meshletTrianglesMax;
+	result->elementContoursMax = tess->elementContoursMax;
+	result->edgeContoursMax = tess->edgeContoursMax;
+	result->metricsMax = tess->metricsMax;
+	result->drawRangesMax = tess->drawRangesMax;
+	result->alloc = tess->alloc;
+
+	tess->vertices = NULL;
+	tess->vertexIndices = NULL;
+	tess->vertexCount = 0;
+	tess->elements = NULL;
+	tess->elementCount = 0;
+	tess->indexCount = 0;
+	tess->meshlets = NULL;
+	tess->meshletCount = 0;
+	tess->meshletVertices = NULL;
+	tess->meshletTriangles = NULL;
+	tess->elementContours = NULL;
+	tess->edgeContours = NULL;
+	tess->metrics = NULL;
+	tess->drawRanges = NULL;
+	tess->verticesMax = 0;
+	tess->vertexIndicesMax = 0;
+	tess->elementsMax = 0;
+	tess->meshletsMax = 0;
+	tess->meshletVerticesMax = 0;
+	tess->meshletTrianglesMax = 0;
+	tess->elementContoursMax = 0;
+	tess->edgeContoursMax = 0;
+	tess->metricsMax = 0;
+	tess->drawRangesMax = 0;
+	tessClearOutput( tess );
+
+	return result;
+}
+
+void tessFreeResult( TESSresult *_Nonnull result )
+{
+	TESSalloc alloc = result->alloc;
+
+	if ( result->vertices != NULL )
+		alloc.memfree( alloc.userData, result->vertices );
+	if ( result->vertexIndices != NULL )
+		alloc.memfree( alloc.userData, result->vertexIndices );
+	if ( result->elements != NULL )
+		alloc.memfree( alloc.userData, result->elements );
+	if ( result->meshlets != NULL )
+		alloc.memfree( alloc.userData, result->meshlets );
+	if ( result->meshletVertices != NULL )
+		alloc.memfree( alloc.userData, result->meshletVertices );
+	if ( result->meshletTriangles != NULL )
+		alloc.memfree( alloc.userData, result->meshletTriangles );
+	if ( result->elementContours != NULL )
+		alloc.memfree( alloc.userData, result->elementContours );
+	if ( result->edgeContours != NULL )
+		alloc.memfree( alloc.userData, result->edgeContours );
+	if ( result->metrics != NULL )
+		alloc.memfree( alloc.userData, result->metrics );
+	if ( result->drawRanges != NULL )
+		alloc.memfree( alloc.userData, result->drawRanges );
+	alloc.memfree( alloc.userData, result );
+}
+
+/* Returns the output buffer buf, or the recycled buffer spare if there is
+* none, in which case *max becomes its length.  A spare which is not needed
+* is freed.
+*/
+static void *RecycleBuffer( TESStesselator *tess, void *buf, int *max, void *spare, int spareMax )
+{
+	if ( spare == NULL )
+		return buf;
+	if ( buf != NULL ) {
+		tess->alloc.memfree( tess->alloc.userData, spare );
+		return buf;
+	}
+	*max = spareMax;
+	return spare;
+}
+
+void tessRecycleResult( TESStesselator *_Nonnull tess, TESSresult *_Nonnull result )
+{
+	tess->vertices = (TESSreal *)RecycleBuffer( tess, tess->vertices, &tess->verticesMax,
+												   result->vertices, result->verticesMax );
+	tess->vertexIndices = (TESSindex *)RecycleBuffer( tess, tess->vertexIndices, &tess->vertexIndicesMax,
+														 result->vertexIndices, result->vertexIndicesMax );
+	tess->elements = (TESSindex *)RecycleBuffer( tess, tess->elements, &tess->elementsMax,
+													result->elements, result->elementsMax );
+	tess->meshlets = (TESSmeshlet *)RecycleBuffer( tess, tess->meshlets, &tess->meshletsMax,
+													  result->meshlets, result->meshletsMax );
+	tess->meshletVertices = (TESSindex *)RecycleBuffer( tess, tess->meshletVertices, &tess->meshletVerticesMax,
+														   result->meshletVertices, result->meshletVerticesMax );
+	tess->meshletTriangles = (unsigned char *)RecycleBuffer( tess, tess->meshletTriangles, &tess->meshletTrianglesMax,
+																result->meshletTriangles, result->meshletTrianglesMax );
+	tess->elementContours = (TESSindex *)RecycleBuffer( tess, tess->elementContours, &tess->elementContoursMax,
+														   result->elementContours, result->elementContoursMax );
+	tess->edgeContours = (TESSindex *)RecycleBuffer( tess, tess->edgeContours, &tess->edgeContoursMax,
+														result->edgeContours, result->edgeContoursMax );
+	tess->metrics = (TESSreal *)RecycleBuffer( tess, tess->metrics, &tess->metricsMax,
+												  result->metrics, result->metricsMax );
+	tess->drawRanges = (TESSdrawRange *)RecycleBuffer( tess, tess->drawRanges, &tess->drawRangesMax,
+														  result->drawRanges, result->drawRangesMax );
+	tess->alloc.memfree( tess->alloc.userData, result );
+}
+
 bool tessGetNoEmptyPolygons( TESStesselator *_Nonnull tess )
 {
     return tess->noEmptyPolygons;
@@ -1007,3 +3677,76 @@ void tessSetNoEmptyPolygons( TESStesselator *_Nonnull tess, bool value )
 {
     tess->noEmptyPolygons = value;
 }
+
+void tessSetCombineCallback( TESStesselator *_Nonnull tess, TESScombineCallback _Nullable callback, void *_Nullable userData )
+{
+	tess->combine = callback;
+	tess->combineUserData = userData;
+}
+
+void tessSetTriangleCallback( TESStesselator *_Nonnull tess, TESStriangleCallback _Nullable callback, void *_Nullable userData )
+{
+	tess->triangleCallback = callback;
+	tess->triangleUserData = userData;
+}
+
+int tessGetDictType( TESStesselator *_Nonnull tess )
+{
+	return tess->dictType;
+}
+
+void tessSetDictType( TESStesselator *_Nonnull tess, int type )
+{
+	tess->dictType = (type == TESS_DICT_LIST) ? TESS_DICT_LIST : TESS_DICT_SKIPLIST;
+}
+
+bool tessGetOptimizeVertexCache( TESStesselator *_Nonnull tess )
+{
+	return tess->optimizeVertexCache;
+}
+
+void tessSetOptimizeVertexCache( TESStesselator *_Nonnull tess, bool value )
+{
+	tess->optimizeVertexCache = value;
+}
+
+bool tessGetDelaunay( TESStesselator *_Nonnull tess )
+{
+	return tess->delaunay;
+}
+
+void tessSetDelaunay( TESStesselator *_Nonnull tess, bool value )
+{
+	tess->delaunay = value;
+}
+
+bool tessGetSimpleContours( TESStesselator *_Nonnull tess )
+{
+	return tess->simpleContours;
+}
+
+void tessSetSimpleContours( TESStesselator *_Nonnull tess, bool value )
+{
+	tess->simpleContours = value;
+}
+
+bool tessGetSimpleViolation( TESStesselator *_Nonnull tess )
+{
+	return tess->simpleViolation;
+}
+
+int tessGetMeshletMaxVertices( TESStesselator *_Nonnull tess )
+{
+	return tess->meshletMaxVertices;
+}
+
+int tessGetMeshletMaxTriangles( TESStesselator *_Nonnull tess )
+{
+	return tess->meshletMaxTriangles;
+}
+
+void tessSetMeshletLimits( TESStesselator *_Nonnull tess, int maxVertices, int maxTriangles )
+{
+	tess->meshletMaxVertices = maxVertices < 3 ? 3 : (maxVertices > 256 ? 256 : maxVertices);
+	tess->meshletMaxTriangles = maxTriangles < 1 ? 1 : (maxTriangles > 512 ? 512 : maxTriangles);
+}
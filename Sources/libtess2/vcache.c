@@ -0,0 +1,225 @@
+/*
+** SGI FREE SOFTWARE LICENSE B (Version 2.0, Sept. 18, 2008) 
+** Copyright (C) [dates of first publication] Silicon Graphics, Inc.
+** All Rights Reserved.
+**
+** Permission is hereby granted, free of charge, to any person obtaining a copy
+** of this software and associated documentation files (the "Software"), to deal
+** in the Software without restriction, including without limitation the rights
+** to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+** of the Software, and to permit persons to whom the Software is furnished to do so,
+** subject to the following conditions:
+** 
+** The above copyright notice including the dates of first publication and either this
+** permission notice or a reference to http://oss.sgi.com/projects/FreeB/ shall be
+** included in all copies or substantial portions of the Software. 
+**
+** THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+** INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+** PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL SILICON GRAPHICS, INC.
+** BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+** TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+** OR OTHER DEALINGS IN THE SOFTWARE.
+** 
+** Except as contained in this notice, the name of Silicon Graphics, Inc. shall not
+** be used in advertising or otherwise to promote the sale, use or other dealings in
+** this Software without prior written authorization from Silicon Graphics, Inc.
+*/
+
+#include <stddef.h>
+#include <assert.h>
+#include <math.h>
+#include "vcache.h"
+
+/* Score weights from Forsyth's paper. */
+#define CACHE_DECAY_POWER	1.5f
+#define LAST_FACE_SCORE		0.75f
+#define VALENCE_BOOST_SCALE	2.0f
+#define VALENCE_BOOST_POWER	0.5f
+#define VALENCE_TABLE_SIZE	32
+
+struct VertexCache {
+	int *valence;		/* faces not yet output, per vertex */
+	int *adjStart;		/* first entry of each vertex in adj */
+	int *adj;			/* faces using each vertex, the live ones first */
+	int *cachePos;		/* position in the simulated cache, or -1 */
+	int *cache;
+	int *newCache;
+	float *vscore;
+	float *fscore;
+	unsigned char *emitted;
+	float cacheScore[VCACHE_SIZE];
+	float valenceScore[VALENCE_TABLE_SIZE];
+};
+
+size_t vcacheScratchSize( int faceCount, int polySize, int vertexCount )
+{
+	size_t ints = (size_t)vertexCount * 3 + 1 + (size_t)faceCount * polySize
+				+ 2 * (VCACHE_SIZE + polySize);
+	size_t floats = (size_t)vertexCount + faceCount;
+	return ints * sizeof(int) + floats * sizeof(float) + faceCount;
+}
+
+static float VertexScore( struct VertexCache *vc, int v )
+{
+	int valence = vc->valence[v];
+	int pos = vc->cachePos[v];
+	float score = 0.0f;
+
+	if( valence == 0 )
+		return -1.0f;	/* no faces left, will not be looked at again */
+
+	if( pos >= 0 )
+		score = vc->cacheScore[pos];
+	if( valence < VALENCE_TABLE_SIZE )
+		score += vc->valenceScore[valence];
+	else
+		score += VALENCE_BOOST_SCALE * powf( (float)valence, -VALENCE_BOOST_POWER );
+	return score;
+}
+
+static float FaceScore( struct VertexCache *vc, const TESSindex *face, int polySize )
+{
+	float score = 0.0f;
+	int i;
+
+	for( i = 0; i < polySize && face[i] != TESS_UNDEF; ++i )
+		score += vc->vscore[face[i]];
+	return score;
+}
+
+void vcacheOrderFaces( const TESSindex *faces, int faceCount, int polySize, int vertexCount,
+					   void *scratch, int *order )
+{
+	struct VertexCache vc;
+	const TESSindex *face;
+	unsigned char *p = (unsigned char *)scratch;
+	int cacheCount = 0, newCount;
+	int best, next = 0;
+	float bestScore;
+	int i, j, k, n, v, f;
+
+	vc.valence = (int *)p;		p += sizeof(int) * vertexCount;
+	vc.adjStart = (int *)p;		p += sizeof(int) * (vertexCount + 1);
+	vc.adj = (int *)p;			p += sizeof(int) * faceCount * polySize;
+	vc.cachePos = (int *)p;		p += sizeof(int) * vertexCount;
+	vc.cache = (int *)p;		p += sizeof(int) * (VCACHE_SIZE + polySize);
+	vc.newCache = (int *)p;		p += sizeof(int) * (VCACHE_SIZE + polySize);
+	vc.vscore = (float *)p;		p += sizeof(float) * vertexCount;
+	vc.fscore = (float *)p;		p += sizeof(float) * faceCount;
+	vc.emitted = p;
+
+	/* The vertices of the last face output score the same, so that the
+	* order in which they were pushed does not matter.
+	*/
+	for( i = 0; i < VCACHE_SIZE; ++i ) {
+		if( i < 3 )
+			vc.cacheScore[i] = LAST_FACE_SCORE;
+		else
+			vc.cacheScore[i] = powf( 1.0f - (float)(i - 3) / (VCACHE_SIZE - 3), CACHE_DECAY_POWER );
+	}
+	vc.valenceScore[0] = 0.0f;
+	for( i = 1; i < VALENCE_TABLE_SIZE; ++i )
+		vc.valenceScore[i] = VALENCE_BOOST_SCALE * powf( (float)i, -VALENCE_BOOST_POWER );
+
+	/* Build the vertex to face adjacency. */
+	for( v = 0; v < vertexCount; ++v ) {
+		vc.valence[v] = 0;
+		vc.cachePos[v] = -1;
+	}
+	for( i = 0; i < faceCount * polySize; ++i ) {
+		if( faces[i] != TESS_UNDEF )
+			vc.valence[faces[i]]++;
+	}
+	vc.adjStart[0] = 0;
+	for( v = 0; v < vertexCount; ++v ) {
+		vc.adjStart[v+1] = vc.adjStart[v] + vc.valence[v];
+		vc.cachePos[v] = vc.adjStart[v];	/* fill cursor for now */
+	}
+	for( f = 0; f < faceCount; ++f ) {
+		face = &faces[f * polySize];
+		for( i = 0; i < polySize && face[i] != TESS_UNDEF; ++i )
+			vc.adj[vc.cachePos[face[i]]++] = f;
+	}
+
+	for( v = 0; v < vertexCount; ++v ) {
+		vc.cachePos[v] = -1;
+		vc.vscore[v] = VertexScore( &vc, v );
+	}
+
+	best = -1;
+	bestScore = -1.0f;
+	for( f = 0; f < faceCount; ++f ) {
+		vc.emitted[f] = 0;
+		vc.fscore[f] = FaceScore( &vc, &faces[f * polySize], polySize );
+		if( vc.fscore[f] > bestScore ) {
+			bestScore = vc.fscore[f];
+			best = f;
+		}
+	}
+
+	for( k = 0; k < faceCount; ++k ) {
+		if( best < 0 ) {
+			/* Nothing in the cache is used by the remaining faces;
+			* continue with the next face in input order.
+			*/
+			while( vc.emitted[next] )
+				++next;
+			best = next;
+		}
+		order[k] = best;
+		vc.emitted[best] = 1;
+		face = &faces[best * polySize];
+
+		/* Retire the face from its vertices, and push them to the
+		* front of the cache.
+		*/
+		newCount = 0;
+		for( i = 0; i < polySize && face[i] != TESS_UNDEF; ++i ) {
+			v = face[i];
+			n = vc.adjStart[v] + vc.valence[v] - 1;
+			for( j = vc.adjStart[v]; vc.adj[j] != best; ++j )
+				assert( j < n );
+			vc.adj[j] = vc.adj[n];
+			vc.adj[n] = best;
+			vc.valence[v]--;
+			vc.newCache[newCount++] = v;
+		}
+		for( i = 0; i < cacheCount; ++i ) {
+			v = vc.cache[i];
+			for( j = 0; j < polySize && face[j] != TESS_UNDEF; ++j ) {
+				if( face[j] == v ) break;
+			}
+			if( j == polySize || face[j] != v )
+				vc.newCache[newCount++] = v;
+		}
+
+		/* Rescore the vertices which moved, including the ones which
+		* fell out of the cache, and the faces around them.
+		*/
+		for( i = 0; i < newCount; ++i )
+			vc.cachePos[vc.newCache[i]] = i < VCACHE_SIZE ? i : -1;
+		for( i = 0; i < newCount; ++i ) {
+			v = vc.newCache[i];
+			vc.vscore[v] = VertexScore( &vc, v );
+		}
+
+		best = -1;
+		bestScore = -1.0f;
+		for( i = 0; i < newCount; ++i ) {
+			v = vc.newCache[i];
+			for( j = vc.adjStart[v]; j < vc.adjStart[v] + vc.valence[v]; ++j ) {
+				f = vc.adj[j];
+				vc.fscore[f] = FaceScore( &vc, &faces[f * polySize], polySize );
+				if( vc.fscore[f] > bestScore ) {
+					bestScore = vc.fscore[f];
+					best = f;
+				}
+			}
+		}
+
+		cacheCount = newCount < VCACHE_SIZE ? newCount : VCACHE_SIZE;
+		for( i = 0; i < cacheCount; ++i )
+			vc.cache[i] = vc.newCache[i];
+	}
+}
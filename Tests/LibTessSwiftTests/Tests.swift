@@ -136,6 +136,752 @@ class Tests: XCTestCase {
         XCTAssertEqual(expectedIndices, indices)
     }
     
+    public func testTesselate_ReusedTesselator_MakesNoAllocationsAfterWarmUp() throws {
+        let pset = try Tests._loader.getAsset(name: "nazca_heron")!.polygon!
+        let contours = pset.polygons.map { poly in
+            poly.points.flatMap { [$0.x, $0.y, $0.z] }
+        }
+        
+        // Counts the calls into the allocator through userData
+        let calls = UnsafeMutablePointer<Int>.allocate(capacity: 1)
+        calls.pointee = 0
+        defer { calls.deallocate() }
+        
+        var alloc = TESSalloc(memalloc: { userData, size in
+                                  userData!.assumingMemoryBound(to: Int.self).pointee += 1
+                                  return malloc(size)
+                              },
+                              memrealloc: nil,
+                              memfree: { _, ptr in free(ptr) },
+                              userData: calls, meshEdgeBucketSize: 0,
+                              meshVertexBucketSize: 0, meshFaceBucketSize: 0,
+                              dictNodeBucketSize: 0, regionBucketSize: 0,
+                              extraVertices: 256)
+        
+        let tess = Tesselator.create(allocator: &alloc)!
+        defer { tess.pointee.destroy() }
+        
+        func tessellate() -> [TESSindex] {
+            for contour in contours {
+                tess.pointee.addContour(size: 3, pointer: contour,
+                                        stride: CInt(MemoryLayout<TESSreal>.size * 3),
+                                        count: CInt(contour.count / 3))
+            }
+            let result = tess.pointee.tesselate(windingRule: Int32(WindingRule.evenOdd.rawValue),
+                                                elementType: Int32(ElementType.polygons.rawValue),
+                                                polySize: 3, vertexSize: 3, normal: nil)
+            XCTAssertEqual(result, 1)
+            
+            let count = Int(tess.pointee.elementCount) * 3
+            return Array(UnsafeBufferPointer(start: tess.pointee.elements, count: count))
+        }
+        
+        let expected = tessellate()
+        let warmUpCalls = calls.pointee
+        XCTAssertGreaterThan(warmUpCalls, 0)
+        
+        for _ in 0..<3 {
+            XCTAssertEqual(tessellate(), expected)
+        }
+        XCTAssertEqual(calls.pointee, warmUpCalls)
+    }
+    
+    public func testTessellateInto_WithInterleavedLayout_MatchesTessellate() throws {
+        let data = "2,0,4\n2,0,2\n4,0,2\n4,0,0\n0,0,0\n0,0,4"
+        
+        let expected = try setupTess(withString: data)
+        try expected.tessellateRaw(windingRule: .evenOdd, elementType: .polygons, polySize: 3)
+        
+        // Interleaved x, y, z and the original vertex index
+        var vertices = [TESSreal](repeating: 0, count: 4 * 4)
+        var indices = [UInt16](repeating: 0, count: 16)
+        var layout = TESSoutputLayout()
+        
+        func tessellate(vertexCapacity: Int) throws -> Bool {
+            let tess = try setupTess(withString: data)
+            
+            return try vertices.withUnsafeMutableBytes { vertexBuffer in
+                try indices.withUnsafeMutableBytes { indexBuffer in
+                    layout.vertices = vertexBuffer.baseAddress
+                    layout.vertexStride = Int32(MemoryLayout<TESSreal>.stride * 4)
+                    layout.positionOffset = 0
+                    layout.vertexIndexOffset = Int32(MemoryLayout<TESSreal>.stride * 3)
+                    layout.vertexCapacity = Int32(vertexCapacity)
+                    layout.elements = indexBuffer.baseAddress
+                    layout.indexType = Int32(TESS_INDEX_UINT16.rawValue)
+                    layout.indexCapacity = Int32(indices.count)
+                    
+                    return try tess.tessellate(into: &layout, windingRule: .evenOdd, elementType: .polygons, polySize: 3)
+                }
+            }
+        }
+        
+        // Too small, only the sizes are reported
+        XCTAssertFalse(try tessellate(vertexCapacity: 4))
+        XCTAssertEqual(Int(layout.vertexCount), expected.vertexCount)
+        XCTAssertEqual(Int(layout.elementCount), expected.elementCount)
+        XCTAssertEqual(Int(layout.indexCount), expected.elementCount * 3)
+        
+        vertices = [TESSreal](repeating: 0, count: Int(layout.vertexCount) * 4)
+        XCTAssertTrue(try tessellate(vertexCapacity: Int(layout.vertexCount)))
+        
+        XCTAssertEqual(indices.prefix(expected.elementCount * 3).map { Int($0) }, expected.elements!)
+        for i in 0..<expected.vertexCount {
+            XCTAssertEqual(Array(vertices[i * 4..<i * 4 + 3]), Array(expected.verticesRaw![i * 3..<i * 3 + 3]))
+            XCTAssertEqual(Int32(bitPattern: vertices[i * 4 + 3].bitPattern), Int32(expected.vertexIndices![i]))
+        }
+    }
+    
+    public func testTessellateInto_WithQuantizedVertices_DequantizesToTessellate() throws {
+        let pset = try Tests._loader.getAsset(name: "nazca_heron")!.polygon!
+        
+        let expected = TessC()!
+        PolyConvert.toTessC(pset: pset, tess: expected)
+        try expected.tessellateRaw(windingRule: .evenOdd, elementType: .polygons, polySize: 3, vertexSize: 2)
+        
+        let tess = TessC()!
+        PolyConvert.toTessC(pset: pset, tess: tess)
+        
+        var vertices = [Int16](repeating: 0, count: expected.vertexCount * 2)
+        var indices = [UInt16](repeating: 0, count: expected.elementCount * 3)
+        var layout = TESSoutputLayout()
+        
+        let written = try vertices.withUnsafeMutableBytes { vertexBuffer in
+            try indices.withUnsafeMutableBytes { indexBuffer -> Bool in
+                layout.vertices = vertexBuffer.baseAddress
+                layout.vertexStride = Int32(MemoryLayout<Int16>.stride * 2)
+                layout.vertexIndexOffset = -1
+                layout.vertexCapacity = Int32(expected.vertexCount)
+                layout.vertexFormat = Int32(TESS_VERTEX_INT16.rawValue)
+                layout.elements = indexBuffer.baseAddress
+                layout.indexType = Int32(TESS_INDEX_UINT16.rawValue)
+                layout.indexCapacity = Int32(indices.count)
+                
+                return try tess.tessellate(into: &layout, windingRule: .evenOdd, elementType: .polygons, polySize: 3, vertexSize: 2)
+            }
+        }
+        XCTAssertTrue(written)
+        XCTAssertEqual(indices.map { Int($0) }, expected.elements!)
+        
+        let scale = [layout.dequantScale.0, layout.dequantScale.1]
+        let offset = [layout.dequantOffset.0, layout.dequantOffset.1]
+        for i in 0..<expected.vertexCount * 2 {
+            let restored = TESSreal(vertices[i]) * scale[i % 2] + offset[i % 2]
+            XCTAssertEqual(restored, expected.verticesRaw![i], accuracy: scale[i % 2])
+        }
+    }
+    
+    public func testTessellateInto_WithExactlySizedBuffers_WritesEdgesAndContours() throws {
+        let pset = try Tests._loader.getAsset(name: "star-intersect")!.polygon!
+        
+        for elementType in [ElementType.edges, .boundaryContours] {
+            let stored = TessC()!
+            PolyConvert.toTessC(pset: pset, tess: stored)
+            let expected = try stored.tessellateDetached(windingRule: .evenOdd, elementType: elementType, polySize: 3, vertexSize: 2)
+            let indexCount = expected.elements.count
+            
+            let tess = TessC()!
+            PolyConvert.toTessC(pset: pset, tess: tess)
+            
+            // The mesh has more vertices and edges than the output uses
+            var vertices = [TESSreal](repeating: 0, count: expected.vertexCount * 2)
+            var indices = [Int32](repeating: 0, count: indexCount)
+            var layout = TESSoutputLayout()
+            
+            let written = try vertices.withUnsafeMutableBytes { vertexBuffer in
+                try indices.withUnsafeMutableBytes { indexBuffer -> Bool in
+                    layout.vertices = vertexBuffer.baseAddress
+                    layout.vertexStride = Int32(MemoryLayout<TESSreal>.stride * 2)
+                    layout.vertexIndexOffset = -1
+                    layout.vertexCapacity = Int32(expected.vertexCount)
+                    layout.elements = indexBuffer.baseAddress
+                    layout.indexType = Int32(TESS_INDEX_INT32.rawValue)
+                    layout.indexCapacity = Int32(indexCount)
+                    
+                    return try tess.tessellate(into: &layout, windingRule: .evenOdd, elementType: elementType, polySize: 3, vertexSize: 2)
+                }
+            }
+            XCTAssertTrue(written)
+            XCTAssertEqual(Int(layout.indexCount), indexCount)
+            XCTAssertEqual(indices, Array(expected.elements))
+            XCTAssertEqual(vertices, Array(expected.vertices))
+        }
+    }
+    
+    public func testTessellateInto_WithIndexPastVertexStride_Fails() throws {
+        let tess = try setupTess(withString: "0,0,0\n0,1,0\n1,1,0")
+        
+        var vertices = [TESSreal](repeating: 0, count: 3 * 3)
+        var indices = [Int32](repeating: 0, count: 3)
+        var layout = TESSoutputLayout()
+        
+        // x, y, z fill the whole stride, leaving no room for the index
+        XCTAssertThrowsError(try vertices.withUnsafeMutableBytes { vertexBuffer in
+            try indices.withUnsafeMutableBytes { indexBuffer -> Bool in
+                layout.vertices = vertexBuffer.baseAddress
+                layout.vertexStride = Int32(MemoryLayout<TESSreal>.stride * 3)
+                layout.vertexIndexOffset = Int32(MemoryLayout<TESSreal>.stride * 2)
+                layout.vertexCapacity = 3
+                layout.elements = indexBuffer.baseAddress
+                layout.indexCapacity = 3
+                
+                return try tess.tessellate(into: &layout, windingRule: .evenOdd, elementType: .polygons, polySize: 3)
+            }
+        })
+    }
+    
+    public func testTessellateInto_ConnectedPolygonsWithUInt16_RejectsTooManyFaces() throws {
+        // Fewer than 65535 vertices, but more faces than 16 bit neighbour indices can number
+        let tess = TessC()!
+        tess.addContour([CVector3(x: 0, y: 0, z: 0), CVector3(x: 290, y: 0, z: 0),
+                         CVector3(x: 290, y: 290, z: 0), CVector3(x: 0, y: 290, z: 0)])
+        for i in 0..<145 {
+            for j in 0..<145 {
+                let (x, y) = (TESSreal(i * 2) + 0.5, TESSreal(j * 2) + 0.5)
+                tess.addContour([CVector3(x: x, y: y, z: 0), CVector3(x: x, y: y + 1, z: 0),
+                                 CVector3(x: x + 1, y: y, z: 0)])
+            }
+        }
+        
+        var vertices = [TESSreal](repeating: 0, count: 70000 * 2)
+        var indices = [UInt16](repeating: 0, count: 2000000)
+        var layout = TESSoutputLayout()
+        
+        let written = try vertices.withUnsafeMutableBytes { vertexBuffer in
+            try indices.withUnsafeMutableBytes { indexBuffer -> Bool in
+                layout.vertices = vertexBuffer.baseAddress
+                layout.vertexStride = Int32(MemoryLayout<TESSreal>.stride * 2)
+                layout.vertexIndexOffset = -1
+                layout.vertexCapacity = 70000
+                layout.elements = indexBuffer.baseAddress
+                layout.indexType = Int32(TESS_INDEX_UINT16.rawValue)
+                layout.indexCapacity = Int32(indices.count)
+                
+                return try tess.tessellate(into: &layout, windingRule: .evenOdd, elementType: .connectedPolygons, polySize: 3, vertexSize: 2)
+            }
+        }
+        XCTAssertFalse(written)
+        XCTAssertLessThan(Int(layout.vertexCount), 0xffff)
+        XCTAssertGreaterThanOrEqual(Int(layout.elementCount), 0xffff)
+    }
+    
+    public func testTessellate_WithCombineCallback_ReportsIntersectionVertex() throws {
+        // Bow tie, the two diagonals cross at (1, 1)
+        let data = "0,0,0\n2,2,0\n2,0,0\n0,2,0"
+        var calls: [(parents: [Int], weights: [TESSreal])] = []
+        
+        let tess = try setupTess(withString: data)
+        tess.combineCallback = { parents, weights, coords in
+            calls.append((parents, weights))
+            coords[2] = 5
+            return 100
+        }
+        
+        try tess.tessellate(windingRule: .evenOdd, elementType: .polygons, polySize: 3)
+        
+        XCTAssertEqual(calls.count, 1)
+        XCTAssertEqual(calls.first?.parents.sorted(), [0, 1, 2, 3])
+        XCTAssertEqual(calls.first?.weights.reduce(0, +) ?? 0, 1, accuracy: 1e-6)
+        
+        guard let i = tess.vertexIndices?.firstIndex(of: 100) else {
+            XCTFail("Expected the intersection vertex to report the combined index")
+            return
+        }
+        XCTAssertEqual(tess.vertices![i], CVector3(x: 1, y: 1, z: 5))
+    }
+    
+    public func testTessellate_WithTriangleStripsAndFans_CoversSameTriangles() throws {
+        let pset = try Tests._loader.getAsset(name: "nazca_heron")!.polygon!
+        
+        let polygons = TessC()!
+        PolyConvert.toTessC(pset: pset, tess: polygons)
+        try polygons.tessellate(windingRule: .evenOdd, elementType: .polygons, polySize: 3)
+        
+        for elementType in [ElementType.triangleStrips, .triangleFans] {
+            let tess = TessC()!
+            PolyConvert.toTessC(pset: pset, tess: tess)
+            let (_, indices) = try tess.tessellate(windingRule: .evenOdd, elementType: elementType, polySize: 3)
+            
+            // Every run of n indices up to a -1 separator makes n - 2 triangles
+            let runs = indices.split(separator: -1, omittingEmptySubsequences: false).dropLast()
+            XCTAssertEqual(runs.count, tess.elementCount)
+            XCTAssertEqual(indices.last, -1)
+            XCTAssert(runs.allSatisfy { $0.count >= 3 })
+            XCTAssertEqual(runs.reduce(0) { $0 + $1.count - 2 }, polygons.elementCount, "\(elementType)")
+        }
+    }
+    
+    public func testTessellate_WithOptimizeVertexCache_LowersCacheMissRatio() throws {
+        let pset = try Tests._loader.getAsset(name: "nazca_heron")!.polygon!
+        
+        let original = TessC()!
+        PolyConvert.toTessC(pset: pset, tess: original)
+        try original.tessellate(windingRule: .evenOdd, elementType: .polygons, polySize: 3)
+        
+        let optimized = TessC()!
+        optimized.optimizeVertexCache = true
+        PolyConvert.toTessC(pset: pset, tess: optimized)
+        try optimized.tessellate(windingRule: .evenOdd, elementType: .polygons, polySize: 3)
+        
+        XCTAssertEqual(optimized.elementCount, original.elementCount)
+        XCTAssertEqual(optimized.vertexCount, original.vertexCount)
+        
+        // Vertices are numbered in the order they are first used
+        var next = 0
+        for index in optimized.elements! where index == next {
+            next += 1
+        }
+        XCTAssertEqual(next, optimized.vertexCount)
+        
+        XCTAssertLessThan(cacheMissRatio(optimized.elements!, cacheSize: 16),
+                          cacheMissRatio(original.elements!, cacheSize: 16))
+    }
+    
+    public func testTessellate_WithMeshlets_PartitionsTrianglesWithinLimits() throws {
+        let pset = try Tests._loader.getAsset(name: "nazca_heron")!.polygon!
+        
+        let tess = TessC()!
+        tess.meshletMaxVertices = 32
+        tess.meshletMaxTriangles = 40
+        PolyConvert.toTessC(pset: pset, tess: tess)
+        let (vertices, indices) = try tess.tessellate(windingRule: .evenOdd, elementType: .meshlets, polySize: 3)
+        
+        let meshlets = tess.meshlets!
+        XCTAssertEqual(meshlets.reduce(0) { $0 + $1.triangles.count / 3 }, tess.elementCount)
+        
+        // The local index buffers, in order, reproduce the element array
+        var global: [Int] = []
+        for meshlet in meshlets {
+            XCTAssertLessThanOrEqual(meshlet.vertices.count, 32)
+            XCTAssertLessThanOrEqual(meshlet.triangles.count, 40 * 3)
+            global.append(contentsOf: meshlet.triangles.map { meshlet.vertices[Int($0)] })
+            
+            for v in meshlet.vertices.map({ vertices[$0] }) {
+                XCTAssert(v.x >= meshlet.boundsMin.x && v.x <= meshlet.boundsMax.x)
+                XCTAssert(v.y >= meshlet.boundsMin.y && v.y <= meshlet.boundsMax.y)
+            }
+        }
+        XCTAssertEqual(global, indices)
+    }
+    
+    public func testTessellate_WithTriangleCallback_ReceivesSameTriangles() throws {
+        let pset = try Tests._loader.getAsset(name: "nazca_heron")!.polygon!
+        
+        // Triangles as original vertex indices, rotated to start at the smallest
+        func normalized(_ t: [Int]) -> [Int] {
+            let i = t.firstIndex(of: t.min()!)!
+            return (0..<3).map { t[(i + $0) % 3] }
+        }
+        
+        let stored = TessC()!
+        PolyConvert.toTessC(pset: pset, tess: stored)
+        let (_, indices) = try stored.tessellate(windingRule: .evenOdd, elementType: .polygons, polySize: 3)
+        let expected = stride(from: 0, to: indices.count, by: 3).map {
+            normalized(indices[$0..<$0 + 3].map { stored.vertexIndices![$0] })
+        }
+        
+        var received: [[Int]] = []
+        let tess = TessC()!
+        tess.triangleCallback = { vertices, vertexIndices in
+            XCTAssertEqual(vertices.count, 9)
+            received.append(normalized(vertexIndices))
+        }
+        PolyConvert.toTessC(pset: pset, tess: tess)
+        let (_, receivedIndices) = try tess.tessellate(windingRule: .evenOdd, elementType: .polygons, polySize: 3)
+        
+        XCTAssert(receivedIndices.isEmpty)
+        XCTAssertEqual(received.sorted { $0.lexicographicallyPrecedes($1) },
+                       expected.sorted { $0.lexicographicallyPrecedes($1) })
+    }
+    
+    public func testTessellateDetached_ResultOutlivesNextTessellation() throws {
+        let heron = try Tests._loader.getAsset(name: "nazca_heron")!.polygon!
+        let star = try Tests._loader.getAsset(name: "star-intersect")!.polygon!
+        
+        let expected = TessC()!
+        PolyConvert.toTessC(pset: heron, tess: expected)
+        let (vertices, indices) = try expected.tessellateRaw(windingRule: .evenOdd, elementType: .polygons, polySize: 3, vertexSize: 2)
+        
+        let tess = TessC()!
+        PolyConvert.toTessC(pset: heron, tess: tess)
+        let first = try tess.tessellateDetached(windingRule: .evenOdd, elementType: .polygons, polySize: 3, vertexSize: 2)
+        PolyConvert.toTessC(pset: star, tess: tess)
+        let second = try tess.tessellateDetached(windingRule: .evenOdd, elementType: .polygons, polySize: 3, vertexSize: 2)
+        
+        XCTAssertEqual(Array(first.vertices), vertices)
+        XCTAssertEqual(first.elements.map { Int($0) }, indices)
+        XCTAssertEqual(first.elementCount, expected.elementCount)
+        XCTAssertGreaterThan(second.elementCount, 0)
+    }
+    
+    public func testTessellate_WithAppendOutput_AccumulatesDrawRanges() throws {
+        let assets = ["nazca_heron", "star-intersect", "redbook-winding"]
+        
+        let tess = TessC()!
+        tess.appendOutput = true
+        
+        var separate: [(vertices: [TESSreal], indices: [Int])] = []
+        for asset in assets {
+            let pset = try Tests._loader.getAsset(name: asset)!.polygon!
+            
+            let single = TessC()!
+            PolyConvert.toTessC(pset: pset, tess: single)
+            separate.append(try single.tessellateRaw(windingRule: .evenOdd, elementType: .polygons, polySize: 3, vertexSize: 2))
+            
+            PolyConvert.toTessC(pset: pset, tess: tess)
+            try tess.tessellateRaw(windingRule: .evenOdd, elementType: .polygons, polySize: 3, vertexSize: 2)
+        }
+        
+        let ranges = tess.drawRanges
+        XCTAssertEqual(ranges.count, assets.count)
+        
+        for (range, expected) in zip(ranges, separate) {
+            let base = Int(range.baseVertex)
+            let first = Int(range.firstIndex)
+            XCTAssertEqual(Array(tess.verticesRaw![base * 2..<(base + Int(range.vertexCount)) * 2]), expected.vertices)
+            XCTAssertEqual(tess.elements![first..<first + Int(range.indexCount)].map { $0 - base }, expected.indices)
+        }
+        XCTAssertEqual(tess.vertexCount, separate.reduce(0) { $0 + $1.vertices.count / 2 })
+        
+        tess.clearOutput()
+        XCTAssert(tess.drawRanges.isEmpty)
+    }
+    
+    public func testTessellateInto_WithAppendOutput_FailsAndKeepsOutput() throws {
+        let tess = TessC()!
+        tess.appendOutput = true
+        tess.addContour([CVector3(x: 0, y: 0, z: 0), CVector3(x: 4, y: 0, z: 0),
+                         CVector3(x: 4, y: 4, z: 0), CVector3(x: 0, y: 4, z: 0)])
+        try tess.tessellateRaw(windingRule: .evenOdd, elementType: .polygons, polySize: 3, vertexSize: 2)
+        
+        var vertices = [TESSreal](repeating: 0, count: 16)
+        var indices = [TESSindex](repeating: 0, count: 16)
+        var layout = TESSoutputLayout()
+        
+        tess.addContour([CVector3(x: 10, y: 0, z: 0), CVector3(x: 14, y: 0, z: 0),
+                         CVector3(x: 12, y: 4, z: 0)])
+        vertices.withUnsafeMutableBytes { vertexBuffer in
+            indices.withUnsafeMutableBytes { indexBuffer in
+                layout.vertices = vertexBuffer.baseAddress
+                layout.vertexStride = Int32(MemoryLayout<TESSreal>.stride * 2)
+                layout.vertexIndexOffset = -1
+                layout.vertexCapacity = 8
+                layout.elements = indexBuffer.baseAddress
+                layout.indexType = Int32(TESS_INDEX_INT32.rawValue)
+                layout.indexCapacity = Int32(indices.count)
+                
+                XCTAssertThrowsError(try tess.tessellate(into: &layout, windingRule: .evenOdd, elementType: .polygons, polySize: 3, vertexSize: 2))
+            }
+        }
+        
+        XCTAssertEqual(tess.drawRanges.count, 1)
+        XCTAssertEqual(Int(tess.tess.pointee.vertexCount), 4)
+    }
+    
+    public func testTessellateDetached_WithAppendOutput_TakesDrawRanges() throws {
+        let tess = TessC()!
+        tess.appendOutput = true
+        tess.addContour([CVector3(x: 0, y: 0, z: 0), CVector3(x: 4, y: 0, z: 0),
+                         CVector3(x: 4, y: 4, z: 0), CVector3(x: 0, y: 4, z: 0)])
+        try tess.tessellateRaw(windingRule: .evenOdd, elementType: .polygons, polySize: 3, vertexSize: 2)
+        tess.addContour([CVector3(x: 10, y: 0, z: 0), CVector3(x: 14, y: 0, z: 0),
+                         CVector3(x: 12, y: 4, z: 0)])
+        let result = try tess.tessellateDetached(windingRule: .evenOdd, elementType: .polygons, polySize: 3, vertexSize: 2)
+        
+        XCTAssertEqual(result.drawRanges.map { Int($0.vertexCount) }, [4, 3])
+        XCTAssertEqual(result.drawRanges.map { Int($0.indexCount) }, [6, 3])
+        XCTAssert(tess.drawRanges.isEmpty)
+        
+        // The next tesselation starts over instead of writing into the result
+        tess.addContour([CVector3(x: 0, y: 0, z: 0), CVector3(x: 1, y: 0, z: 0),
+                         CVector3(x: 0, y: 1, z: 0)])
+        try tess.tessellateRaw(windingRule: .evenOdd, elementType: .polygons, polySize: 3, vertexSize: 2)
+        XCTAssertEqual(tess.drawRanges.count, 1)
+        XCTAssertEqual(result.drawRanges.count, 2)
+    }
+    
+    public func testTessellate_WithProvenance_ReportsSourceContours() throws {
+        let tess = TessC()!
+        tess.provenance = true
+        tess.addContour([CVector3(x: 0, y: 0, z: 0), CVector3(x: 4, y: 0, z: 0),
+                         CVector3(x: 4, y: 4, z: 0), CVector3(x: 0, y: 4, z: 0)])
+        tess.addContour([CVector3(x: 10, y: 0, z: 0), CVector3(x: 14, y: 0, z: 0),
+                         CVector3(x: 14, y: 4, z: 0), CVector3(x: 10, y: 4, z: 0)])
+        
+        let (vertices, indices) = try tess.tessellate(windingRule: .evenOdd, elementType: .polygons, polySize: 3)
+        
+        let elementContours = tess.elementContours!
+        let edgeContours = tess.edgeContours!
+        XCTAssertEqual(elementContours.count, 4)
+        
+        for i in 0..<elementContours.count {
+            let triangle = indices[i * 3..<i * 3 + 3].map { vertices[$0] }
+            let contour = triangle[0].x < 5 ? 0 : 1
+            XCTAssertEqual(elementContours[i], contour)
+            
+            // Sides of the squares come from their contour, diagonals from neither
+            for j in 0..<3 {
+                let a = triangle[j], b = triangle[(j + 1) % 3]
+                XCTAssertEqual(edgeContours[i * 3 + j], a.x == b.x || a.y == b.y ? contour : -1)
+            }
+        }
+    }
+    
+    public func testTessellate_WithElementMetrics_MatchesContours() throws {
+        let tess = TessC()!
+        tess.computeElementMetrics = true
+        // L shape, made of a 2x2 and a 1x2 rectangle
+        tess.addContour([CVector3(x: 0, y: 0, z: 0), CVector3(x: 3, y: 0, z: 0),
+                         CVector3(x: 3, y: 1, z: 0), CVector3(x: 2, y: 1, z: 0),
+                         CVector3(x: 2, y: 2, z: 0), CVector3(x: 0, y: 2, z: 0)])
+        
+        try tess.tessellate(windingRule: .evenOdd, elementType: .boundaryContours, polySize: 3)
+        
+        let metrics = tess.elementMetrics!
+        XCTAssertEqual(metrics.count, 1)
+        XCTAssertEqual(metrics[0].area, 5, accuracy: 1e-5)
+        XCTAssertEqual(metrics[0].boundsMin, CVector3(x: 0, y: 0, z: 0))
+        XCTAssertEqual(metrics[0].boundsMax, CVector3(x: 3, y: 2, z: 0))
+        XCTAssertEqual(metrics[0].centroid.x, 6.5 / 5, accuracy: 1e-5)
+        XCTAssertEqual(metrics[0].centroid.y, 4.5 / 5, accuracy: 1e-5)
+        
+        // The triangles cover the same area
+        try tess.tessellate(windingRule: .evenOdd, elementType: .polygons, polySize: 3)
+        
+        let triangles = tess.elementMetrics!
+        XCTAssertEqual(triangles.count, tess.elementCount)
+        XCTAssertEqual(triangles.reduce(0) { $0 + $1.area }, 5, accuracy: 1e-5)
+    }
+    
+    public func testTessellate_WithEdges_FlagsBoundaryEdges() throws {
+        let tess = TessC()!
+        tess.addContour([CVector3(x: 0, y: 0, z: 0), CVector3(x: 4, y: 0, z: 0),
+                         CVector3(x: 4, y: 4, z: 0), CVector3(x: 0, y: 4, z: 0)])
+        
+        let (vertices, indices) = try tess.tessellate(windingRule: .evenOdd, elementType: .edges, polySize: 3)
+        
+        // Two triangles: the four sides and the shared diagonal
+        let boundaryEdges = tess.boundaryEdges!
+        XCTAssertEqual(boundaryEdges.count, 5)
+        XCTAssertEqual(indices.count, 10)
+        XCTAssertEqual(boundaryEdges.filter { $0 }.count, 4)
+        
+        for i in 0..<boundaryEdges.count {
+            let a = vertices[indices[i * 2]], b = vertices[indices[i * 2 + 1]]
+            XCTAssertEqual(boundaryEdges[i], a.x == b.x || a.y == b.y)
+        }
+    }
+    
+    public func testTessellate_WithPolySize_MergesIntoConvexPolygons() throws {
+        let pset = try Tests._loader.getAsset(name: "nazca_heron")!.polygon!
+        let polySize = 8
+        
+        func area(_ polygon: [CVector3]) -> TESSreal {
+            return (0..<polygon.count).reduce(TESSreal(0)) { sum, j in
+                let a = polygon[j], b = polygon[(j + 1) % polygon.count]
+                return sum + (a.x * b.y - b.x * a.y) / 2
+            }
+        }
+        
+        let triangles = TessC()!
+        PolyConvert.toTessC(pset: pset, tess: triangles)
+        let (triangleVertices, triangleIndices) = try triangles.tessellate(windingRule: .evenOdd, elementType: .polygons, polySize: 3)
+        let triangleArea = stride(from: 0, to: triangleIndices.count, by: 3).reduce(TESSreal(0)) { sum, i in
+            sum + abs(area(triangleIndices[i..<i + 3].map { triangleVertices[$0] }))
+        }
+        
+        let tess = TessC()!
+        PolyConvert.toTessC(pset: pset, tess: tess)
+        let (vertices, _) = try tess.tessellate(windingRule: .evenOdd, elementType: .polygons, polySize: polySize)
+        XCTAssertLessThan(tess.elementCount, triangles.elementCount)
+        
+        let elements = tess.tess.pointee.elements!
+        var polygonArea: TESSreal = 0
+        for i in 0..<tess.elementCount {
+            let polygon = (0..<polySize).map { elements[i * polySize + $0] }.filter { $0 != ~TESSindex() }
+            XCTAssertGreaterThanOrEqual(polygon.count, 3)
+            polygonArea += abs(area(polygon.map { vertices[Int($0)] }))
+            
+            // All turns go the same way
+            let turns = (0..<polygon.count).map { j -> TESSreal in
+                let a = vertices[Int(polygon[j])]
+                let b = vertices[Int(polygon[(j + 1) % polygon.count])]
+                let c = vertices[Int(polygon[(j + 2) % polygon.count])]
+                return (b.x - a.x) * (c.y - b.y) - (b.y - a.y) * (c.x - b.x)
+            }
+            XCTAssert(turns.allSatisfy { $0 >= -1e-3 } || turns.allSatisfy { $0 <= 1e-3 })
+        }
+        
+        // The merged polygons cover the triangles exactly
+        XCTAssertEqual(polygonArea, triangleArea, accuracy: triangleArea * 1e-4)
+    }
+    
+    public func testTessellate_WithTrapezoids_CoversPolygon() throws {
+        let tess = TessC()!
+        // Square with a notch in its top
+        tess.addContour([CVector3(x: 0, y: 0, z: 0), CVector3(x: 4, y: 0, z: 0),
+                         CVector3(x: 4, y: 4, z: 0), CVector3(x: 2, y: 1, z: 0),
+                         CVector3(x: 0, y: 4, z: 0)])
+        
+        let (vertices, indices) = try tess.tessellate(windingRule: .evenOdd, elementType: .trapezoids, polySize: 3)
+        
+        XCTAssertEqual(tess.elementCount, 2)
+        XCTAssertEqual(indices.count, 8)
+        
+        var area: TESSreal = 0
+        for i in 0..<tess.elementCount {
+            let c = indices[i * 4..<i * 4 + 4].map { vertices[$0] }
+            XCTAssertEqual(c[0].x, c[3].x)
+            XCTAssertEqual(c[1].x, c[2].x)
+            area += (c[1].x - c[0].x) * ((c[3].y - c[0].y) + (c[2].y - c[1].y)) / 2
+        }
+        XCTAssertEqual(area, 10, accuracy: 1e-5)
+    }
+    
+    public func testTessellate_WithDelaunay_AvoidsSlivers() throws {
+        // A long bottom edge under an arch, which the sweep fans from one end
+        let contour = [CVector3(x: 0, y: 0, z: 0), CVector3(x: 10, y: 0, z: 0),
+                       CVector3(x: 9, y: 1, z: 0), CVector3(x: 7, y: 1.3, z: 0),
+                       CVector3(x: 5, y: 1.4, z: 0), CVector3(x: 3, y: 1.3, z: 0),
+                       CVector3(x: 1, y: 1, z: 0)]
+        
+        func smallestAngle(_ tess: TessC) throws -> TESSreal {
+            let (vertices, indices) = try tess.tessellate(windingRule: .nonZero, elementType: .polygons, polySize: 3)
+            XCTAssertEqual(tess.elementCount, 5)
+            
+            var smallest = TESSreal.pi
+            for i in 0..<indices.count {
+                let a = vertices[indices[i]]
+                let b = vertices[indices[i % 3 == 2 ? i - 2 : i + 1]]
+                let c = vertices[indices[i % 3 == 0 ? i + 2 : i - 1]]
+                let (ux, uy, wx, wy) = (b.x - a.x, b.y - a.y, c.x - a.x, c.y - a.y)
+                smallest = min(smallest, atan2(abs(ux * wy - uy * wx), ux * wx + uy * wy))
+            }
+            return smallest * 180 / .pi
+        }
+        
+        let fan = TessC()!
+        fan.addContour(contour)
+        XCTAssertLessThan(try smallestAngle(fan), 5)
+        
+        let delaunay = TessC()!
+        delaunay.delaunay = true
+        delaunay.addContour(contour)
+        XCTAssertGreaterThan(try smallestAngle(delaunay), 7.5)
+    }
+    
+    public func testTessellate_WithSimpleContours_MatchesFullSweep() throws {
+        let outer = [CVector3(x: 0, y: 0, z: 0), CVector3(x: 4, y: 0, z: 0),
+                     CVector3(x: 4, y: 4, z: 0), CVector3(x: 0, y: 4, z: 0)]
+        let hole = [CVector3(x: 1, y: 1, z: 0), CVector3(x: 1, y: 3, z: 0),
+                    CVector3(x: 3, y: 3, z: 0), CVector3(x: 3, y: 1, z: 0)]
+        
+        let tess = TessC()!
+        tess.simpleContours = true
+        tess.addContour(outer)
+        tess.addContour(hole)
+        let (vertices, indices) = try tess.tessellate(windingRule: .nonZero, elementType: .polygons, polySize: 3)
+        XCTAssertEqual(tess.elementCount, 8)
+        XCTAssertFalse(tess.simpleViolation)
+        
+        var area: TESSreal = 0
+        for t in stride(from: 0, to: indices.count, by: 3) {
+            let (a, b, c) = (vertices[indices[t]], vertices[indices[t + 1]], vertices[indices[t + 2]])
+            area += ((b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x)) / 2
+        }
+        XCTAssertEqual(area, 12, accuracy: 1e-5)
+        
+        #if DEBUG
+        // A bow-tie crosses itself, which the checks of debug builds report
+        tess.addContour([CVector3(x: 0, y: 0, z: 0), CVector3(x: 2, y: 2, z: 0),
+                         CVector3(x: 2, y: 0, z: 0), CVector3(x: 0, y: 2, z: 0)])
+        XCTAssertThrowsError(try tess.tessellate(windingRule: .nonZero, elementType: .polygons, polySize: 3))
+        XCTAssertTrue(tess.simpleViolation)
+        #endif
+    }
+    
+    public func testTessellate_ConvexContour_MatchesSweep() throws {
+        // Provenance keeps the contour in the mesh, so the second run sweeps
+        let hexagon = [CVector3(x: 2, y: 0, z: 0), CVector3(x: 1, y: 1.7, z: 0),
+                       CVector3(x: -1, y: 1.7, z: 0), CVector3(x: -2, y: 0, z: 0),
+                       CVector3(x: -1, y: -1.7, z: 0), CVector3(x: 1, y: -1.7, z: 0)]
+        
+        for windingRule in [WindingRule.evenOdd, .nonZero, .positive, .negative] {
+            let direct = TessC()!
+            direct.addContour(hexagon)
+            let (directVertices, directIndices) = try direct.tessellate(windingRule: windingRule, elementType: .polygons, polySize: 3)
+            
+            let swept = TessC()!
+            swept.provenance = true
+            swept.addContour(hexagon)
+            let (sweptVertices, sweptIndices) = try swept.tessellate(windingRule: windingRule, elementType: .polygons, polySize: 3)
+            
+            XCTAssertEqual(direct.elementCount, windingRule == .negative ? 0 : 4)
+            XCTAssertEqual(directIndices, sweptIndices)
+            XCTAssertEqual(directVertices.map { [$0.x, $0.y] }, sweptVertices.map { [$0.x, $0.y] })
+            XCTAssertEqual(direct.vertexIndices!, swept.vertexIndices!)
+        }
+    }
+    
+    public func testRasterize_WithHole_CoversInside() throws {
+        let tess = TessC()!
+        tess.addContour([CVector3(x: 0, y: 0, z: 0), CVector3(x: 4, y: 0, z: 0),
+                         CVector3(x: 4, y: 4, z: 0), CVector3(x: 0, y: 4, z: 0)])
+        tess.addContour([CVector3(x: 1, y: 1, z: 0), CVector3(x: 1, y: 3, z: 0),
+                         CVector3(x: 3, y: 3, z: 0), CVector3(x: 3, y: 1, z: 0)])
+        
+        var mask = [UInt8](repeating: 0, count: 16)
+        try tess.rasterize(into: &mask, width: 4, height: 4, windingRule: .nonZero)
+        
+        XCTAssertEqual(mask, [255, 255, 255, 255,
+                              255,   0,   0, 255,
+                              255,   0,   0, 255,
+                              255, 255, 255, 255])
+        
+        // Edges crossing pixels give partial coverage
+        tess.addContour([CVector3(x: 0, y: 0, z: 0), CVector3(x: 2, y: 0, z: 0),
+                         CVector3(x: 0, y: 2, z: 0)])
+        
+        mask = [UInt8](repeating: 0, count: 4)
+        try tess.rasterize(into: &mask, width: 2, height: 2, windingRule: .evenOdd, viewBox: [0, 0, 2, 2])
+        
+        XCTAssertEqual(mask, [255, 128, 128, 0])
+    }
+    
+    public func testTessellate_WithListDictionary_MatchesSkipListDictionary() throws {
+        for asset in ["star-intersect", "nazca_heron", "redbook-winding"] {
+            let pset = try Tests._loader.getAsset(name: asset)!.polygon!
+            
+            for winding in WindingRule.allCases {
+                let list = TessC()!
+                list.edgeDictionary = .list
+                PolyConvert.toTessC(pset: pset, tess: list)
+                try list.tessellate(windingRule: winding, elementType: .polygons, polySize: 3)
+                
+                let skipList = TessC()!
+                skipList.edgeDictionary = .skipList
+                PolyConvert.toTessC(pset: pset, tess: skipList)
+                try skipList.tessellate(windingRule: winding, elementType: .polygons, polySize: 3)
+                
+                XCTAssertEqual(list.elements!, skipList.elements!, "\(asset), \(winding)")
+            }
+        }
+    }
+    
+    // Benchmarks the edge dictionary: every strip spans the whole sweep, so
+    // all of their edges are in the dictionary at once.
+    public func testPerformance_StackedStrips_ListDictionary() {
+        measure {
+            tessellateStackedStrips(count: 4000, edgeDictionary: .list)
+        }
+    }
+    
+    public func testPerformance_StackedStrips_SkipListDictionary() {
+        measure {
+            tessellateStackedStrips(count: 4000, edgeDictionary: .skipList)
+        }
+    }
+    
     public func testTessellate_WithAssets_ReturnsExpectedTriangulation() {
         
         // Multi-task the test
@@ -295,4 +1041,37 @@ extension Tests {
         
         return tess
     }
+    
+    /// Average number of vertex cache misses per triangle, for a FIFO cache
+    func cacheMissRatio(_ indices: [Int], cacheSize: Int) -> Double {
+        var cache: [Int] = []
+        var misses = 0
+        
+        for index in indices where !cache.contains(index) {
+            misses += 1
+            cache.append(index)
+            if cache.count > cacheSize {
+                cache.removeFirst()
+            }
+        }
+        
+        return Double(misses) / Double(indices.count / 3)
+    }
+    
+    func tessellateStackedStrips(count: Int, edgeDictionary: EdgeDictionary) {
+        let tess = TessC(usePooling: false)!
+        tess.edgeDictionary = edgeDictionary
+        
+        for i in 0..<count {
+            // Stagger the ends so that no two strips share an event
+            let x0 = TESSreal(i * 7919 % 101) * 0.01
+            let x1 = 100 + TESSreal(i * 104729 % 103) * 0.01
+            let y = TESSreal(i * 2)
+            
+            tess.addContourRaw([x0, y, x1, y, x1, y + 1, x0, y + 1], vertexSize: .vertex2)
+        }
+        
+        XCTAssertNoThrow(try tess.tessellateRaw(windingRule: .evenOdd, elementType: .polygons, polySize: 3, vertexSize: 2))
+        XCTAssertEqual(tess.elementCount, count * 2)
+    }
 }